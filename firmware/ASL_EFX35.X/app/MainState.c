@@ -64,7 +64,8 @@ static int g_SwitchDelay;
 static uint8_t g_ExeternalSwitchStatus;
 
 //static BeepPattern_t g_BeepPatternRequest = BEEPER_PATTERN_EOL;
-static uint8_t g_MainTaskID = 0;
+static uint32_t g_MainTaskReleaseTime;  // Release time of the current period, in OS ticks
+static DeadlineId_t g_MainTaskDeadlineID;
 
 
 //------------------------------------------------------------------------------
@@ -73,7 +74,6 @@ static uint8_t g_MainTaskID = 0;
 static void NewTask (void);
 
 //static void MainTaskInitialise(void);
-static void MainTask (void);
 static void MirrorDigitalInputOnBluetoothOutput(void);
 
 // The following are the states
@@ -100,6 +100,7 @@ static void Driving_Setup_State (void);
 //          - Send BT beeping sequence.
 //          - switch to Bluetooth Setup state.
 static void Driving_State (void);
+static void PadDriveDemand (int *speedPercentage, int *directionPercentage);
 //static void Driving_UserSwitchActivated (void);
 static void Driving_UserSwitch_State (void);
 static void Driving_Idle_State (void);
@@ -137,7 +138,7 @@ void MainTaskInitialise(void)
     
     MainState = Startup_State;
 
-    g_MainTaskID = task_create(MainTask , NULL, MAIN_TASK_PRIO, NULL, 0, 0);
+    g_MainTaskDeadlineID = AppCommonDeadlineRegister(MAIN_TASK_DELAY, MAIN_TASK_DEADLINE, NULL);
 
 
 }
@@ -147,10 +148,12 @@ void MainTaskInitialise(void)
 // Description: This is the main task that controls everything.
 //-------------------------------------------------------------------------
 
-static void MainTask (void)
+void MainTask (void)
 {
     task_open();
 
+    g_MainTaskReleaseTime = os_tick_count_get();
+
     while (1)
 	{
         // Get the User and Mode port switch status all of the time.
@@ -158,13 +161,38 @@ static void MainTask (void)
         
         MainState();
 
-        task_wait(MILLISECONDS_TO_TICKS(MAIN_TASK_DELAY));
+        AppCommonDeadlineComplete(g_MainTaskDeadlineID);
+
+        task_wait_until(g_MainTaskReleaseTime, MILLISECONDS_TO_TICKS(MAIN_TASK_DELAY));
 
     }
     
     task_close();
 }
 
+//-------------------------------------------------------------------------
+// Function: MainPadsChanged
+// Description: Called by the head array task when a pad changes. While
+//      driving, the new drive demand is passed to the eFix task now instead
+//      of at the next run of the main task, and likewise the pads are
+//      mirrored to the Bluetooth module. The state counters are not
+//      touched, they still count main task periods.
+//-------------------------------------------------------------------------
+void MainPadsChanged (void)
+{
+    int speedPercentage = 0, directionPercentage = 0;
+
+    if (MainState == Driving_State)
+    {
+        PadDriveDemand (&speedPercentage, &directionPercentage);
+        SetSpeedAndDirection (speedPercentage, directionPercentage);
+    }
+    else if (MainState == DoBluetooth_State)
+    {
+        MirrorDigitalInputOnBluetoothOutput();
+    }
+}
+
 //-------------------------------------------------------------------------
 static void Idle_State (void)
 {
@@ -267,27 +295,7 @@ static void Driving_State (void)
 {
     int speedPercentage = 0, directionPercentage = 0;
 
-    if (!PadsInNeutralState())      // Nope we are not in neutral
-    {
-        // Determine which is active and set the output accordingly.
-        // Note that the Left/Right override is performed at the lower level.
-        if (headArrayDigitalInputValue(HEAD_ARRAY_SENSOR_LEFT)) // Is Left pad active?
-        {
-            directionPercentage = -100;
-        }
-        else if (headArrayDigitalInputValue(HEAD_ARRAY_SENSOR_RIGHT)) // Is right pad active?
-        {
-            directionPercentage = 100;
-        }
-        else if (headArrayDigitalInputValue(HEAD_ARRAY_SENSOR_CENTER)) // Is center pad active?
-        {
-            speedPercentage = 100;
-        }
-        else if (headArrayDigitalInputValue(HEAD_ARRAY_SENSOR_BACK)) // Is 4th back pad active?
-        {
-            speedPercentage = -100;
-        }
-    }
+    PadDriveDemand (&speedPercentage, &directionPercentage);
     
     // Check the user port for active... If so, change to Bluetooth state.
     if (g_ExeternalSwitchStatus & USER_SWITCH)
@@ -309,6 +317,39 @@ static void Driving_State (void)
     SetSpeedAndDirection (speedPercentage, directionPercentage);
 }
 
+//-------------------------------------------------------------------------
+// Function: PadDriveDemand
+// Description: 
+//      Sets the speed and direction demand from the active pad. A
+//      proportional pad gives a demand graded by how hard it is pressed.
+//-------------------------------------------------------------------------
+static void PadDriveDemand (int *speedPercentage, int *directionPercentage)
+{
+    uint8_t pads = headArrayDigitalInputs();
+
+    if (pads != 0)      // Nope we are not in neutral
+    {
+        // Determine which is active and set the output accordingly.
+        // Note that the Left/Right override is performed at the lower level.
+        if (pads & HEAD_ARRAY_PAD_BIT(HEAD_ARRAY_SENSOR_LEFT)) // Is Left pad active?
+        {
+            *directionPercentage = -(int)headArrayProportionalInputValue (HEAD_ARRAY_SENSOR_LEFT);
+        }
+        else if (pads & HEAD_ARRAY_PAD_BIT(HEAD_ARRAY_SENSOR_RIGHT)) // Is right pad active?
+        {
+            *directionPercentage = headArrayProportionalInputValue (HEAD_ARRAY_SENSOR_RIGHT);
+        }
+        else if (pads & HEAD_ARRAY_PAD_BIT(HEAD_ARRAY_SENSOR_CENTER)) // Is center pad active?
+        {
+            *speedPercentage = headArrayProportionalInputValue (HEAD_ARRAY_SENSOR_CENTER);
+        }
+        else if (pads & HEAD_ARRAY_PAD_BIT(HEAD_ARRAY_SENSOR_BACK)) // Is 4th back pad active?
+        {
+            *speedPercentage = -(int)headArrayProportionalInputValue (HEAD_ARRAY_SENSOR_BACK);
+        }
+    }
+}
+
 //-------------------------------------------------------------------------
 // Driving_UserSwitch_State
 //      Stay here until
@@ -415,10 +456,7 @@ static void DoBluetooth_State (void)
 //------------------------------------------------------------------------------
 static void MirrorDigitalInputOnBluetoothOutput(void)
 {
-	for (int i = 0; i < (int) HEAD_ARRAY_SENSOR_EOL; i++)
-	{
-		bluetoothSimpleIfBspPadMirrorStateSet((HeadArraySensor_t)i, headArrayDigitalInputValue(i));
-	}
+	bluetoothSimpleIfBspPadMirrorSet(headArrayDigitalInputs());
 }
 
 //------------------------------------------------------------------------------
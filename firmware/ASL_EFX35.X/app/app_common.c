@@ -36,21 +36,32 @@
 
 /* ******************************   Macros   ****************************** */
 
-// Execution rate for this module's task, in milliseconds.
-#define SYS_SUPERVISOR_TASK_EXECUTION_RATE_ms (20)
-
 /* ******************************   Types   ******************************* */
 
-
+// A periodic task watched by the deadline monitor. The deadline is the longest time allowed
+// between two completions of the task, e.g. the eFix watchdog time for the eFix task.
+typedef struct
+{
+    uint32_t m_Period;              // Expected time between completions, OS ticks
+    uint32_t m_Deadline;            // Max time between completions, OS ticks
+    uint32_t m_LastCompletion;      // OS tick count of the last completion
+    bool m_InMiss;                  // The current gap has been counted as a miss
+    void (*m_OnMiss)(void);         // Called once per miss, NULL if none
+    DeadlineStats_t m_Stats;
+} DeadlineMonitor_t;
 
 /* ***********************   File Scope Variables   *********************** */
 
 static volatile bool device_is_active;
+
+static DeadlineMonitor_t g_DeadlineMonitors[MAX_DEADLINE_MONITORS];
+static uint8_t g_NumDeadlineMonitors = 0;
 //static volatile bool device_in_calibration;
 
 /* ***********************   Function Prototypes   ************************ */
 
-static void SystemSupervisorTask(void);
+static void CheckDeadlines(void);
+static void DeadlineGapCheck(DeadlineMonitor_t *monitor, uint32_t gap);
 inline static void ManageEepromDataFlush(void);
 
 /* *******************   Public Function Definitions   ******************** */
@@ -67,7 +78,6 @@ void AppCommonInit(void)
     
     //device_in_calibration = false;
 
-    (void)task_create(SystemSupervisorTask , NULL, SYSTEM_SUPERVISOR_TASK_PRIO, NULL, 0, 0);
 }
 
 //-------------------------------
@@ -238,6 +248,68 @@ bool AppCommonDeviceActiveGet(void)
 	return device_is_active;
 }
 
+//-------------------------------
+// Function: AppCommonDeadlineRegister
+//
+// Description: Registers a periodic task with the deadline monitor of the system
+//      supervisor. The task must call AppCommonDeadlineComplete() every time it has
+//      done its periodic work. Call before os_start().
+//
+// Parameters: period_ms - Expected time between completions.
+//      deadline_ms - Longest time allowed between completions.
+//      on_miss - Called from the supervisor task, or from the task itself, when the
+//          deadline is missed. NULL if nothing has to be done.
+//
+// Returns: The id to pass to AppCommonDeadlineComplete().
+//
+//-------------------------------
+DeadlineId_t AppCommonDeadlineRegister(uint16_t period_ms, uint16_t deadline_ms, void (*on_miss)(void))
+{
+    DeadlineMonitor_t *monitor;
+
+    ASSERT(g_NumDeadlineMonitors < MAX_DEADLINE_MONITORS);
+
+    monitor = &g_DeadlineMonitors[g_NumDeadlineMonitors];
+    monitor->m_Period = MILLISECONDS_TO_TICKS((uint32_t)period_ms);
+    monitor->m_Deadline = MILLISECONDS_TO_TICKS((uint32_t)deadline_ms);
+    monitor->m_LastCompletion = os_tick_count_get();
+    monitor->m_InMiss = false;
+    monitor->m_OnMiss = on_miss;
+    monitor->m_Stats.m_Misses = 0;
+    monitor->m_Stats.m_WorstLateness = 0;
+    monitor->m_Stats.m_WorstGap = 0;
+
+    return g_NumDeadlineMonitors++;
+}
+
+//-------------------------------
+// Function: AppCommonDeadlineComplete
+//
+// Description: Marks the end of the periodic work of a registered task.
+//
+//-------------------------------
+void AppCommonDeadlineComplete(DeadlineId_t id)
+{
+    DeadlineMonitor_t *monitor = &g_DeadlineMonitors[id];
+    uint32_t now = os_tick_count_get();
+
+    DeadlineGapCheck(monitor, now - monitor->m_LastCompletion);
+
+    monitor->m_LastCompletion = now;
+    monitor->m_InMiss = false;
+}
+
+//-------------------------------
+// Function: AppCommonDeadlineStatsGet
+//
+// Description: Gets the miss count and the latched worst case timing of a registered task.
+//
+//-------------------------------
+void AppCommonDeadlineStatsGet(DeadlineId_t id, DeadlineStats_t *stats)
+{
+    *stats = g_DeadlineMonitors[id].m_Stats;
+}
+
 //-------------------------------
 // Function: AppCommonCalibrationActiveSet
 //
@@ -270,18 +342,74 @@ bool AppCommonDeviceActiveGet(void)
 // Description: System monitoring duties.
 //
 //-------------------------------
-static void SystemSupervisorTask(void)
+void SystemSupervisorTask(void)
 {
     task_open();
 	while (1)
 	{
 		task_wait(MILLISECONDS_TO_TICKS(SYS_SUPERVISOR_TASK_EXECUTION_RATE_ms));
 		
+		CheckDeadlines();
+
 		//ManageEepromDataFlush();
 	}
 	task_close();
 }
 
+//-------------------------------
+// Function: CheckDeadlines
+//
+// Description: Catches the registered tasks that have not completed within their
+//      deadline while they are still late, so the miss is handled before the task
+//      runs again. The supervisor has the highest priority, so it runs first.
+//
+//-------------------------------
+static void CheckDeadlines(void)
+{
+    uint32_t now = os_tick_count_get();
+    uint8_t i;
+
+    for (i = 0; i < g_NumDeadlineMonitors; ++i)
+    {
+        DeadlineGapCheck(&g_DeadlineMonitors[i], now - g_DeadlineMonitors[i].m_LastCompletion);
+    }
+}
+
+//-------------------------------
+// Function: DeadlineGapCheck
+//
+// Description: Updates the worst case timing with the time since the last completion,
+//      and counts and handles a miss once per gap.
+//
+//-------------------------------
+static void DeadlineGapCheck(DeadlineMonitor_t *monitor, uint32_t gap)
+{
+    if (gap > monitor->m_Stats.m_WorstGap)
+    {
+        monitor->m_Stats.m_WorstGap = gap;
+    }
+
+    if ((gap > monitor->m_Period) && ((gap - monitor->m_Period) > monitor->m_Stats.m_WorstLateness))
+    {
+        monitor->m_Stats.m_WorstLateness = gap - monitor->m_Period;
+    }
+
+    if ((gap > monitor->m_Deadline) && (monitor->m_InMiss == false))
+    {
+        monitor->m_InMiss = true;
+
+        if (monitor->m_Stats.m_Misses != UINT16_MAX)
+        {
+            ++monitor->m_Stats.m_Misses;
+        }
+
+        if (monitor->m_OnMiss != NULL)
+        {
+            monitor->m_OnMiss();
+        }
+    }
+}
+
 //-------------------------------
 // Function: ManageEepromDataFlush
 //
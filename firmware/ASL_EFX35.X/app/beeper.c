@@ -87,11 +87,12 @@ static uint8_t g_PatternIndex;
 static uint8_t g_PatternStep;
 static void (*BeepStateEngine)(void);
 
-uint8_t g_BeeperTaskID = 0;
 int IGotAMsg = 0;
 static Msg_t g_LastBeepMsg;
 static bool g_NewBeep = false;
 static uint16_t g_Delay;
+static uint32_t g_BeeperTaskReleaseTime; // Release time of the current period, in OS ticks
+static DeadlineId_t g_BeeperTaskDeadlineID;
 
 const Beep_t g_BeepPatterns[MAX_BEEP_PATTERNS][MAX_BEEPS_PER_PATTERN] = 
 {
@@ -142,7 +143,6 @@ static volatile Sem_t data_lock_mutex;
 
 /* ***********************   Function Prototypes   ************************ */
 
-static void BeepPatternTask(void);
 
 // State Engine
 static void BeepReady (void);
@@ -282,7 +282,7 @@ void beeperInit(void)
 	//os_event_beep_seq_complete = event_create();
 //    beeper_task_id = task_create(BeepPatternTask, NULL, BEEPER_MGMT_TASK_PRIO, NULL, 0, 0 );
 //    g_BeeperTaskID = task_create(BeepPatternTask, NULL, BEEPER_MGMT_TASK_PRIO, g_BeepMsgPool, BEEP_POOL_SIZE, sizeof (Msg_t)); // sizeof (BeepMsg_t));
-    g_BeeperTaskID = task_create(BeepPatternTask, NULL, BEEPER_MGMT_TASK_PRIO, NULL, 0, 0);
+    g_BeeperTaskDeadlineID = AppCommonDeadlineRegister(BEEPER_TASK_DELAY, BEEPER_TASK_DEADLINE, NULL);
 
 }
 
@@ -295,15 +295,17 @@ void beeperInit(void)
 //
 //-------------------------------
 
-static void BeepPatternTask(void)
+void BeepPatternTask(void)
 {
     BeepPattern_t pattern;
     
     task_open();
 
+    g_BeeperTaskReleaseTime = os_tick_count_get();
+
     while (1)
     {
-        task_wait(MILLISECONDS_TO_TICKS(BEEPER_TASK_DELAY));
+        task_wait_until(g_BeeperTaskReleaseTime, MILLISECONDS_TO_TICKS(BEEPER_TASK_DELAY));
 
         if (g_NewBeepPattern != BEEPER_PATTERN_EOL)
         {
@@ -341,6 +343,8 @@ static void BeepPatternTask(void)
         
 
         BeepStateEngine();
+
+        AppCommonDeadlineComplete(g_BeeperTaskDeadlineID);
 	}
     task_close();
 }
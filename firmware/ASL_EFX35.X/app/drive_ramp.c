@@ -0,0 +1,285 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Filename: drive_ramp.c
+//
+// Description: Ramps the drive demand sent to the eFix, limiting the acceleration
+//      and the jerk.
+//
+// Author(s): G. Chopcinski (Kg Solutions, LLC)
+//
+// Modified for ASL on Date:
+//
+//////////////////////////////////////////////////////////////////////////////
+
+
+/* **************************   Header Files   *************************** */
+
+// NOTE: This must ALWAYS be the first include in a file.
+#include "device.h"
+
+// from stdlib
+#include <stdint.h>
+#include <stdbool.h>
+#include "user_assert.h"
+
+// from project
+#include "eeprom_app.h"
+
+// from local
+#include "drive_ramp.h"
+
+/* ******************************   Macros   ****************************** */
+
+// The ramp is run once per period while it moves, see SendSpeedAndDirection_State().
+#define RAMP_PERIOD_ms              (DRIVE_RAMP_PERIOD_ms)
+
+// The demand is kept in eFix counts, -1000 to +1000, with 8 fraction bits, so
+// slow ramps still move by a fraction of a count each period.
+#define RAMP_ONE                    ((int32_t)1 << 8)
+#define RAMP_COUNTS_PER_PERCENT     (10)
+
+/* ******************************   Types   ******************************* */
+
+// A profile in steps per ramp period, in 1/RAMP_ONE counts. 0 means no limit.
+typedef struct
+{
+    uint16_t accel;     // Demand change per period away from neutral
+    uint16_t decel;     // Demand change per period towards neutral
+    uint16_t jerk;      // Change of the above per period
+} RampSteps_t;
+
+typedef struct
+{
+    int32_t value;      // Demand sent, 1/RAMP_ONE counts
+    int32_t rate;       // Change of the demand in the last period
+} RampAxis_t;
+
+/* ***********************   File Scope Variables   *********************** */
+
+static RampSteps_t g_RampSteps[DRIVE_RAMP_PROFILE_EOL];
+static RampAxis_t g_SpeedRamp;
+static RampAxis_t g_DirectionRamp;
+static bool g_RampSettled;          // Both axes were at their targets after the last update
+
+/* ***********************   Function Prototypes   ************************ */
+
+static uint16_t RampStep(uint8_t per_s, uint8_t num_periods);
+static void RampAxis(RampAxis_t *axis, int16_t target, const RampSteps_t *positive, const RampSteps_t *negative);
+
+/* *******************   Public Function Definitions   ******************** */
+
+//------------------------------------------------------------------------------
+// Function: driveRampInit
+//
+// Description: Initializes this module.
+//
+//------------------------------------------------------------------------------
+void driveRampInit(void)
+{
+#ifdef ASL110
+    driveRampProfileSet(DRIVE_RAMP_PROFILE_FORWARD, eeprom8bitGet(EEPROM_STORED_ITEM_RAMP_FWD_ACCEL),
+            eeprom8bitGet(EEPROM_STORED_ITEM_RAMP_FWD_DECEL), eeprom8bitGet(EEPROM_STORED_ITEM_RAMP_FWD_JERK));
+    driveRampProfileSet(DRIVE_RAMP_PROFILE_REVERSE, eeprom8bitGet(EEPROM_STORED_ITEM_RAMP_REV_ACCEL),
+            eeprom8bitGet(EEPROM_STORED_ITEM_RAMP_REV_DECEL), eeprom8bitGet(EEPROM_STORED_ITEM_RAMP_REV_JERK));
+    driveRampProfileSet(DRIVE_RAMP_PROFILE_TURN, eeprom8bitGet(EEPROM_STORED_ITEM_RAMP_TURN_ACCEL),
+            eeprom8bitGet(EEPROM_STORED_ITEM_RAMP_TURN_DECEL), eeprom8bitGet(EEPROM_STORED_ITEM_RAMP_TURN_JERK));
+#else
+    driveRampProfileSet(DRIVE_RAMP_PROFILE_FORWARD, DRIVE_RAMP_FWD_ACCEL_DEFAULT, DRIVE_RAMP_FWD_DECEL_DEFAULT, DRIVE_RAMP_FWD_JERK_DEFAULT);
+    driveRampProfileSet(DRIVE_RAMP_PROFILE_REVERSE, DRIVE_RAMP_REV_ACCEL_DEFAULT, DRIVE_RAMP_REV_DECEL_DEFAULT, DRIVE_RAMP_REV_JERK_DEFAULT);
+    driveRampProfileSet(DRIVE_RAMP_PROFILE_TURN, DRIVE_RAMP_TURN_ACCEL_DEFAULT, DRIVE_RAMP_TURN_DECEL_DEFAULT, DRIVE_RAMP_TURN_JERK_DEFAULT);
+#endif
+    driveRampStop();
+}
+
+//------------------------------------------------------------------------------
+// Function: driveRampProfileSet
+//
+// Description: Sets a profile. accel and decel are in percent of full demand per
+//      second, jerk in percent per second per second. 0 means no limit. They are
+//      converted to steps per ramp period here, so a period only adds and compares.
+//
+//------------------------------------------------------------------------------
+void driveRampProfileSet(DriveRampProfile_t profile, uint8_t accel, uint8_t decel, uint8_t jerk)
+{
+    ASSERT(profile < DRIVE_RAMP_PROFILE_EOL);
+
+    g_RampSteps[profile].accel = RampStep(accel, 1);
+    g_RampSteps[profile].decel = RampStep(decel, 1);
+    g_RampSteps[profile].jerk = RampStep(jerk, 2);
+}
+
+//------------------------------------------------------------------------------
+// Function: driveRampUpdate
+//
+// Description: Moves the demand one ramp period towards the targets, in eFix counts.
+//      Must be called once per DRIVE_RAMP_PERIOD_ms while the ramp is not settled.
+//      Speed uses the forward and reverse profiles, direction uses the turn
+//      profile on both sides.
+//
+//------------------------------------------------------------------------------
+void driveRampUpdate(int16_t speed_target, int16_t direction_target)
+{
+    RampAxis(&g_SpeedRamp, speed_target, &g_RampSteps[DRIVE_RAMP_PROFILE_FORWARD], &g_RampSteps[DRIVE_RAMP_PROFILE_REVERSE]);
+    RampAxis(&g_DirectionRamp, direction_target, &g_RampSteps[DRIVE_RAMP_PROFILE_TURN], &g_RampSteps[DRIVE_RAMP_PROFILE_TURN]);
+
+    g_RampSettled = (g_SpeedRamp.value == (int32_t)speed_target * RAMP_ONE)
+            && (g_DirectionRamp.value == (int32_t)direction_target * RAMP_ONE);
+}
+
+//------------------------------------------------------------------------------
+// Function: driveRampStop
+//
+// Description: Sets the demand to neutral at once, without ramping.
+//
+//------------------------------------------------------------------------------
+void driveRampStop(void)
+{
+    g_SpeedRamp.value = 0;
+    g_SpeedRamp.rate = 0;
+    g_DirectionRamp.value = 0;
+    g_DirectionRamp.rate = 0;
+    g_RampSettled = true;
+}
+
+//------------------------------------------------------------------------------
+// Function: driveRampSettled
+//
+// Description: Returns true if the demand reached the targets of the last update.
+//      The ramp then needs no update until the targets change.
+//
+//------------------------------------------------------------------------------
+bool driveRampSettled(void)
+{
+    return g_RampSettled;
+}
+
+//------------------------------------------------------------------------------
+// Function: driveRampSpeedGet
+//
+// Description: Returns the ramped speed demand, in eFix counts.
+//
+//------------------------------------------------------------------------------
+int16_t driveRampSpeedGet(void)
+{
+    return (int16_t)(g_SpeedRamp.value / RAMP_ONE);
+}
+
+//------------------------------------------------------------------------------
+// Function: driveRampDirectionGet
+//
+// Description: Returns the ramped direction demand, in eFix counts.
+//
+//------------------------------------------------------------------------------
+int16_t driveRampDirectionGet(void)
+{
+    return (int16_t)(g_DirectionRamp.value / RAMP_ONE);
+}
+
+/* ********************   Private Function Definitions   ****************** */
+
+//------------------------------------------------------------------------------
+// Function: RampStep
+//
+// Description: Converts a rate in percent per second, to the power of num_periods,
+//      to 1/RAMP_ONE counts per ramp period. Rounded, at least 1 unless the rate is 0.
+//
+//------------------------------------------------------------------------------
+static uint16_t RampStep(uint8_t per_s, uint8_t num_periods)
+{
+    uint32_t step;
+
+    if (per_s == 0)
+    {
+        return 0;
+    }
+
+    step = (uint32_t)per_s * RAMP_COUNTS_PER_PERCENT * RAMP_ONE;
+
+    while (num_periods-- > 0)
+    {
+        step = ((step * RAMP_PERIOD_ms) + 500) / 1000;
+    }
+
+    if (step == 0)
+    {
+        step = 1;
+    }
+    else if (step > UINT16_MAX)
+    {
+        step = UINT16_MAX;
+    }
+    return (uint16_t)step;
+}
+
+//------------------------------------------------------------------------------
+// Function: RampAxis
+//
+// Description: Moves one axis a ramp period towards its target. The demand changes
+//      by no more than the acceleration, or the deceleration towards neutral. An
+//      acceleration builds up by no more than the jerk and drops at once. The
+//      deceleration is not jerk limited, so slowing down is never held back. Going
+//      through neutral, the axis comes to neutral first and then takes the profile
+//      of the other side.
+//
+//------------------------------------------------------------------------------
+static void RampAxis(RampAxis_t *axis, int16_t target, const RampSteps_t *positive, const RampSteps_t *negative)
+{
+    int32_t goal = (int32_t)target * RAMP_ONE;
+    int32_t value = axis->value;
+    int32_t rate = axis->rate;
+    int32_t step;
+    uint16_t limit;
+    bool away;
+    const RampSteps_t *steps;
+
+    if (((goal < 0) && (value > 0)) || ((goal > 0) && (value < 0)))
+    {
+        goal = 0;
+    }
+
+    step = goal - value;
+    if (step == 0)
+    {
+        axis->rate = 0;
+        return;
+    }
+
+    steps = ((value > 0) || ((value == 0) && (goal > 0))) ? positive : negative;
+
+    // Slew limit, away from neutral is acceleration, towards it deceleration
+    away = (value == 0) || ((step > 0) == (value > 0));
+    limit = away ? steps->accel : steps->decel;
+    if ((limit != 0) && (step > (int32_t)limit))
+    {
+        step = limit;
+    }
+    else if ((limit != 0) && (step < -(int32_t)limit))
+    {
+        step = -(int32_t)limit;
+    }
+
+    // A change the other way drops the last one at once
+    if ((step > 0) != (rate > 0))
+    {
+        rate = 0;
+    }
+
+    // Jerk limit, only on an acceleration that builds up
+    if (away && (steps->jerk != 0))
+    {
+        if ((step > 0) && (step > rate + steps->jerk))
+        {
+            step = rate + steps->jerk;
+        }
+        else if ((step < 0) && (step < rate - steps->jerk))
+        {
+            step = rate - steps->jerk;
+        }
+    }
+
+    axis->rate = step;
+    axis->value = value + step;
+}
+
+// end of file.
+//-------------------------------------------------------------------------
@@ -35,18 +35,14 @@
 #include "head_array_bsp.h" // TODO: Expose MIN/MAX values in head_array driver module
 #include "head_array.h"
 #include "app_common.h"
+#include "drive_ramp.h"
+#include "test_gpio.h"
 
 #include "inc/eFix_Communication.h"
 #include "RS232.h"
 
 /* **************************   Local Macro Declarations   *************************** */
 
-// The eFix 35 system is expecting messages at least every 100 milliseconds,
-// otherwise, a hard errror occurs.
-// I'm choosinig 53 milliseconds so we don't over task the 104.
-//#define EFIX_COMM_TASK_DELAY (15)
-#define EFIX_COMM_TASK_DELAY (53)
-
 #define TO_EFIX_SOT (0xeb)       // Start Of Transmission Character when sending to eFix
 #define FROM_EFIX_SOT (0xbe)     // This is the start character when receiving a message
 
@@ -57,30 +53,80 @@
 #define DIRECTION_LEFT (-1000)
 #define DIRECTION_RIGHT (1000)
 
+#define DEMAND_PERCENT_MAX (100)
+#define EFIX_COUNTS_PER_PERCENT (SPEED_FORWARD / DEMAND_PERCENT_MAX)
+
+#define EFIX_MSG_LENGTH (6)
+
+// Message IDs
+#define EFIX_MSG_ID_STEERING (0x01)
+#define EFIX_MSG_ID_SPEED (0x02)
+#define EFIX_MSG_ID_SETUP (0x04)      // Also the no command message
+#define EFIX_MSG_ID_MAX_SPEED (0x08)
+
+// The checksum is the negative of the sum of the first 4 bytes, high byte first.
+// These build a whole message at compile time.
+#define EFIX_CHECKSUM(b0, b1, b2, b3) ((uint16_t)(0x10000UL - ((b0) + (b1) + (b2) + (b3))))
+#define EFIX_MSG(id, b2, b3) { TO_EFIX_SOT, (id), (b2), (b3), \
+        (unsigned char)(EFIX_CHECKSUM(TO_EFIX_SOT, (id), (b2), (b3)) >> 8), \
+        (unsigned char)(EFIX_CHECKSUM(TO_EFIX_SOT, (id), (b2), (b3)) & 0xff) }
+// Two messages take about 1 ms at 115.2K. Wait for them, but not forever.
+#define EFIX_XMT_DONE_TIMEOUT_ms (5)
+// The ramp catches up at most this many periods when the task was held up.
+#define EFIX_RAMP_CATCH_UP_MAX (4)
+#define EFIX_RAMP_PERIOD_TICKS MILLISECONDS_TO_TICKS(DRIVE_RAMP_PERIOD_ms)
+
+// A reply from the eFix is laid out like the messages sent to it, with its own SOT.
+// Byte 1 is the ID of the message replied to, byte 2 the status, byte 3 the
+// error code, followed by the 2 byte checksum.
+#define EFIX_REPLY_ID_INDEX (1)
+#define EFIX_REPLY_STATUS_INDEX (2)
+#define EFIX_REPLY_ERROR_INDEX (3)
+#define EFIX_REPLY_STATUS_READY (0x55)  // Status of an eFix ready to drive
+#define EFIX_REPLY_ERROR_NONE (0x00)
+#define EFIX_REPLY_ID_NONE (0x00)       // No message has this ID, no reply is waited for
+// Without a good reply for this long, the eFix is taken as not ready.
+#define EFIX_REPLY_TIMEOUT_ms (250)
+
+// Time for the eFix to power up before the first setup message.
+#define EFIX_SETUP_POWER_UP_ms (50)
+// Time for the eFix to take a setup message, ended early by its reply.
+#define EFIX_SETUP_ACK_TIMEOUT_ms (20)
+// Time for the eFix to take a message it does not reply to, before the next one.
+// It is not known which messages the eFix takes back to back, so every step has it.
+#define EFIX_SETUP_SETTLE_ms (10)
+
 /* **************************   Forward Declarations   *************************** */
 
-static void eFix_Communication_Task (void);
-void Create_NoCommand_Msg(unsigned char *buffer);
-static void Create_eFix_1st_Setup_Msg(unsigned char *buffer);
-static void Create_eFix_2nd_Setup_Msg(unsigned char *buffer);
-static void Create_eFix_MaxSpeed_Message(unsigned char *buffer);
-static void Create_eFix_Steering_Message (unsigned char *buffer, int direction);
-static void Create_eFix_Speed_Message(unsigned char *buffer, int speed);
-static void SendMessageToEFIX (unsigned char *buffer);
+static void eFixForceNeutral (void);
+static void CommandChanged (void);
+static void Create_eFix_Steering_Message (int direction);
+static void Create_eFix_Speed_Message (int speed);
+static void SetDrivePayload (unsigned char *buffer, uint16_t neutralChecksum, int value);
+static void SendMessageToEFIX (const unsigned char *buffer);
+static bool ParseReceivedChar (unsigned char item);
+static bool ChecksumValid (const unsigned char *buffer);
+static void ProcessReply (const unsigned char *buffer);
+static void ReplyTimeout (void);
+static void WakeTask (void);
 
 // State Engine
-static void SendMaxSpeedMessage_State (void);
-static void Send1st_NoCommandMessage_State (void);
-static void Send2nd_NoCommandMessage_State (void);
-static void Send3rd_NoCommandMessage_State (void);
+static void SendSetupSequence_State (void);
 static void SendSpeedAndDirection_State (void);
-static void Send1stSetupMessage_State (void);
-static void Send2ndSetupMessage_State (void);
 static void Idle_State (void);
 
+/* **************************   Local Types   *************************** */
+
+// One step of the startup handshake, see g_SetupSteps.
+typedef struct
+{
+    const unsigned char *message;   // The message to send
+    uint8_t delay_ms;       // Wait after sending, before the next step. 0 = none.
+    uint8_t replyId;        // A reply with this ID ends the wait early, or EFIX_REPLY_ID_NONE
+} SetupStep_t;
+
 /* **************************    Local Variables   *************************** */
 
-unsigned char g_XmtBuffer[8];
 void (*gpState)(void);
 int g_Direction;
 int g_Speed;
@@ -91,36 +137,167 @@ int g_ReceivedCounter = 0;
 int g_Received55Counter = 0;
 int g_ReceiveTimeout = 0;
 int g_SendCounter = 0;
+int g_XmtDroppedCounter = 0;        // Messages that did not fit in the transmit ring
+int g_ReceiveChecksumErrors = 0;
+static Evt_t g_WakeEvent;               // Wakes the task for a new command or a reply
+static bool g_WakeNow = false;          // Set with the event, the task may not be waiting for it
+static uint16_t g_eFixWaitTicks;        // Until the next message, unless woken. 0 = no wait.
+static uint32_t g_RampTime;             // OS tick of the last ramp update
+static DeadlineId_t g_eFixTaskDeadlineID;
+static bool g_ForceNeutral = false;     // Commands are held at neutral until the input is neutral
 char myChar = 0xff;
 char myBadChar = 0x41;
 unsigned char g_XmtChar = 0;
 
+// Reply parser, see ParseReceivedChar()
+static unsigned char g_RcvBuffer[EFIX_MSG_LENGTH];
+static uint8_t g_RcvCount = 0;
+static uint32_t g_LastReplyTime;        // OS tick of the last good reply
+static bool g_eFixReady = false;        // Published status of the eFix
+static uint8_t g_eFixErrorCode = EFIX_REPLY_ERROR_NONE;
+
+// The blank, do nothing message.
+static const unsigned char g_NoCommandMsg[EFIX_MSG_LENGTH] = EFIX_MSG(EFIX_MSG_ID_SETUP, 0x00, 0x00);
+
+// The Maximum Speed message, high byte 0x64.
+static const unsigned char g_MaxSpeedMsg[EFIX_MSG_LENGTH] = EFIX_MSG(EFIX_MSG_ID_MAX_SPEED, 0x64, 0x00);
+
+// The setup messages. Byte 2 is the Button Function byte:
+//      D6 1 = Light Function, D5 = on/off
+//      D4 1 = Menu, D3 = Activate/Deactivate
+//      D2 1 = Horn, D1 = on/off
+//      D0 1 - Active Joystick Raw transmission
+// Byte 3 is the Special Function byte:
+//      0x80 = Default Max Speed is via E3x control panel
+//      0xD0 = Default Max speed is via 0x08 cmd
+//      0xE0 = Drive commands through joystick in the E3x control panel.
+//      0xB0 = Drive commands via CMD's 0x01 and 0x02.
+// The 1st sets up the unit to use the front panel speed pot.
+static const unsigned char g_1stSetupMsg[EFIX_MSG_LENGTH] = EFIX_MSG(EFIX_MSG_ID_SETUP, 0x40, 0x80);
+static const unsigned char g_2ndSetupMsg[EFIX_MSG_LENGTH] = EFIX_MSG(EFIX_MSG_ID_SETUP, 0x00, 0xB0);
+
+// The Direction (steering) and Speed messages. Only the payload and the
+// checksum are written, see SetDrivePayload().
+static unsigned char g_SteeringMsg[EFIX_MSG_LENGTH] = EFIX_MSG(EFIX_MSG_ID_STEERING, 0x00, 0x00);
+static unsigned char g_SpeedMsg[EFIX_MSG_LENGTH] = EFIX_MSG(EFIX_MSG_ID_SPEED, 0x00, 0x00);
+
+// The startup handshake. No message goes out back to back with the one before it.
+static const SetupStep_t g_SetupSteps[] =
+{
+    // No reply is expected, give the eFix the settle time.
+    { g_MaxSpeedMsg, EFIX_SETUP_SETTLE_ms, EFIX_REPLY_ID_NONE },
+    { g_NoCommandMsg, EFIX_SETUP_SETTLE_ms, EFIX_REPLY_ID_NONE },
+    // Given time to be taken, the reply to it ends the wait early.
+    { g_1stSetupMsg, EFIX_SETUP_ACK_TIMEOUT_ms, EFIX_MSG_ID_SETUP },
+    // The same settle time before the 2nd setup message as before the 1st.
+    { g_NoCommandMsg, EFIX_SETUP_SETTLE_ms, EFIX_REPLY_ID_NONE },
+    { g_2ndSetupMsg, EFIX_SETUP_ACK_TIMEOUT_ms, EFIX_MSG_ID_SETUP },
+    // Settled before the first drive message.
+    { g_NoCommandMsg, EFIX_SETUP_SETTLE_ms, EFIX_REPLY_ID_NONE },
+};
+#define NUM_SETUP_STEPS (sizeof(g_SetupSteps) / sizeof(g_SetupSteps[0]))
+
+static uint8_t g_SetupStep = 0;         // Next step of g_SetupSteps to send
+static uint8_t g_SetupAckId = EFIX_REPLY_ID_NONE;   // ID of the reply the step sent waits for
+int g_SetupAckTimeouts = 0;             // Setup messages the eFix did not reply to
+
 //------------------------------------------------------------------------------
 // Function: SetSpeedAndDirection
 //
 // Description: This accepts speed and direction from...
-//      Speed is -100 (left), to 0 (neutral) to 100 (right)
-//      Direction is -100 (reverse), to 0 (neutral) to 100 (forward)
+//      Speed is -100 (reverse), to 0 (neutral) to 100 (forward)
+//      Direction is -100 (left), to 0 (neutral) to 100 (right)
+//      Both are scaled to the -1000 to +1000 of the eFix, so a proportional
+//      pad gives a graded demand. Values out of range are limited.
 //
 //------------------------------------------------------------------------------
 
 void SetSpeedAndDirection (int speedPercentage, int directionPercentage)
 {
-//    g_Speed = speedPercentage * 9;            // Convert to -1000 to +1000
-//    g_Direction = directionPercentage * 9;    // Convert to -1000 to +1000
-    if (speedPercentage > 0)
-        g_Speed = SPEED_FORWARD;
-    else if (speedPercentage < 0)
-        g_Speed = SPEED_REVERSE;
-    else
-        g_Speed = SPEED_NEUTRAL;
-    
-    if (directionPercentage > 0)
-        g_Direction = DIRECTION_RIGHT;
-    else if (directionPercentage < 0)
-        g_Direction = DIRECTION_LEFT;
-    else
-        g_Direction = DIRECTION_NEUTRAL;
+    // After a missed deadline, drive again only once the user has let go.
+    if (g_ForceNeutral)
+    {
+        if ((speedPercentage != 0) || (directionPercentage != 0))
+            return;
+        g_ForceNeutral = false;
+    }
+
+    if (speedPercentage > DEMAND_PERCENT_MAX)
+        speedPercentage = DEMAND_PERCENT_MAX;
+    else if (speedPercentage < -DEMAND_PERCENT_MAX)
+        speedPercentage = -DEMAND_PERCENT_MAX;
+
+    if (directionPercentage > DEMAND_PERCENT_MAX)
+        directionPercentage = DEMAND_PERCENT_MAX;
+    else if (directionPercentage < -DEMAND_PERCENT_MAX)
+        directionPercentage = -DEMAND_PERCENT_MAX;
+
+    speedPercentage *= EFIX_COUNTS_PER_PERCENT;         // Convert to -1000 to +1000
+    directionPercentage *= EFIX_COUNTS_PER_PERCENT;     // Convert to -1000 to +1000
+
+    if ((speedPercentage != g_Speed) || (directionPercentage != g_Direction))
+    {
+        g_Speed = speedPercentage;
+        g_Direction = directionPercentage;
+        CommandChanged();
+    }
+}
+
+//------------------------------------------------------------------------------
+// Function: CommandChanged
+//
+// Description: Wakes the eFix task to send the new command now, instead of at
+//      the next keep-alive. The setup messages keep their spacing, so only a
+//      task that is sending commands is woken.
+//
+//------------------------------------------------------------------------------
+
+static void CommandChanged (void)
+{
+    if (gpState == SendSpeedAndDirection_State)
+    {
+        WakeTask();
+    }
+}
+
+//------------------------------------------------------------------------------
+// Function: WakeTask
+//
+// Description: Ends the wait of the eFix task. The ISR form of the signal does
+//      not yield, so this can be called from any task.
+//
+//------------------------------------------------------------------------------
+
+static void WakeTask (void)
+{
+    g_WakeNow = true;
+    event_ISR_signal(g_WakeEvent);
+}
+
+//------------------------------------------------------------------------------
+// Function: eFixIsReady
+//
+// Description: Returns true if the last reply of the eFix says it is ready to
+//      drive, and that reply is recent.
+//
+//------------------------------------------------------------------------------
+
+bool eFixIsReady (void)
+{
+    return g_eFixReady;
+}
+
+//------------------------------------------------------------------------------
+// Function: eFixErrorCodeGet
+//
+// Description: Returns the error code of the last reply of the eFix,
+//      0 if none.
+//
+//------------------------------------------------------------------------------
+
+uint8_t eFixErrorCodeGet (void)
+{
+    return g_eFixErrorCode;
 }
 
 //------------------------------------------------------------------------------
@@ -136,12 +313,32 @@ void eFix_Communincation_Initialize(void)
     
     g_Direction = DIRECTION_NEUTRAL; // Preset to No Command
     g_Speed = SPEED_NEUTRAL;        // Preset to No Speed
+    driveRampInit();
+    g_WakeEvent = event_create();
+    g_eFixWaitTicks = MILLISECONDS_TO_TICKS(EFIX_SETUP_POWER_UP_ms);
     
-    gpState = SendMaxSpeedMessage_State;
-    
-    // Create the state update and control task
-    (void)task_create(eFix_Communication_Task, NULL, EFIX_COMM_TASK_PRIO, NULL, 0, 0);
+    g_SetupStep = 0;
+    gpState = SendSetupSequence_State;
     
+    g_eFixTaskDeadlineID = AppCommonDeadlineRegister(EFIX_COMM_TASK_DELAY, EFIX_COMM_TASK_DEADLINE, eFixForceNeutral);
+}
+
+//------------------------------------------------------------------------------
+// Function: eFixForceNeutral
+//
+// Description: Called by the system supervisor when this task has missed the
+//      eFix watchdog deadline. The next messages command neutral, and keep doing
+//      so until SetSpeedAndDirection() is given a neutral input.
+//
+//------------------------------------------------------------------------------
+
+static void eFixForceNeutral (void)
+{
+    g_ForceNeutral = true;
+    g_Speed = SPEED_NEUTRAL;
+    g_Direction = DIRECTION_NEUTRAL;
+    driveRampStop();                // No ramp down, the eFix is overdue already
+    CommandChanged();
 }
 
 //------------------------------------------------------------------------------
@@ -151,121 +348,157 @@ void eFix_Communincation_Initialize(void)
 //
 //------------------------------------------------------------------------------
 
-static void eFix_Communication_Task (void)
+void eFix_Communication_Task (void)
 {
    
     task_open();
 
     while (1)
 	{
-        task_wait(MILLISECONDS_TO_TICKS(EFIX_COMM_TASK_DELAY));
+        // A wake up that came while this task was busy is taken without waiting.
+        if ((g_WakeNow == false) && (g_eFixWaitTicks != 0))
+        {
+            event_wait_timeout(g_WakeEvent, g_eFixWaitTicks);
+        }
+        g_WakeNow = false;
         
+#ifdef EFIX_COMMS_TIMING_TEST
+        testGpioSet(TEST_GPIO_1, true);
+#endif
         gpState();
-        
+#ifdef EFIX_COMMS_TIMING_TEST
+        testGpioSet(TEST_GPIO_1, false);
+#endif
+
+        // The messages go out by interrupt. The period is complete once they are out.
+        // If the done event came before this wait, the transmitter is already idle.
+        event_wait_timeout_unless(RS232_TransmitDoneEvent(), MILLISECONDS_TO_TICKS(EFIX_XMT_DONE_TIMEOUT_ms), RS232_TransmitIdle());
+
+        AppCommonDeadlineComplete(g_eFixTaskDeadlineID);
     }
     
     task_close();
 }
 
 //------------------------------------------------------------------------------
-// Function: IdleState
-// Description: Do nothing state. Essentially for debugging.
+// Function: eFix_Receive_Task
+//
+// Description: Takes the characters received from the eFix as they come in,
+//      and publishes the status of every good reply. Wakes on each character,
+//      or when no reply came for a while.
+//
 //------------------------------------------------------------------------------
-int g_IdleStateCounter = 0;
 
-static void Idle_State (void)
+void eFix_Receive_Task (void)
 {
-    ++g_IdleStateCounter;
-}
+    unsigned char item;
 
-//------------------------------------------------------------------------------
-// Function: SendMaxSpeedMessage_State
-// Description: This state sends the Maximum Speed Message to the eFix system
-// and then sets the state to send a No Command Message
-//------------------------------------------------------------------------------
-static void SendMaxSpeedMessage_State (void) 
-{
-    Create_eFix_MaxSpeed_Message (g_XmtBuffer);
-    SendMessageToEFIX (g_XmtBuffer);
-    gpState = Send1st_NoCommandMessage_State;
-}
+    task_open();
 
-//------------------------------------------------------------------------------
-// Function: 
-// Description: This is State executed within the State Engine. It sends a
-// No Command message to the eFix System and then sets the state to Send the Setup
-// message state.
-//------------------------------------------------------------------------------
-static void Send1st_NoCommandMessage_State (void)
-{
-    Create_NoCommand_Msg(g_XmtBuffer);
-    SendMessageToEFIX (g_XmtBuffer);
-    gpState = Send1stSetupMessage_State;
-}
+    g_LastReplyTime = os_tick_count_get();
 
-//------------------------------------------------------------------------------
-// Function: Send1stSetupMessage_State
-// Description: This state sends the Maximum Speed Message to the eFix system and then
-//      sets the state to send a No Command Message
-//------------------------------------------------------------------------------
-static void Send1stSetupMessage_State(void)
-{
-    Create_eFix_1st_Setup_Msg(g_XmtBuffer);
-    SendMessageToEFIX (g_XmtBuffer);
-    gpState = Send2nd_NoCommandMessage_State;
-}
+    while (1)
+    {
+        // A character that came after the ring was emptied below is taken without waiting.
+        event_wait_timeout_unless(RS232_ReceiveEvent(), MILLISECONDS_TO_TICKS(EFIX_REPLY_TIMEOUT_ms), RS232_ReceivePending());
 
-//------------------------------------------------------------------------------
-// Function: Send2nd_NoCommandMessage_State
-// Description: This state sends a NOP to the eFix system.
-// and then sets the state to send a the 2nd setup message to the eFix system.
-//------------------------------------------------------------------------------
-static void Send2nd_NoCommandMessage_State (void)
-{
-    Create_NoCommand_Msg(g_XmtBuffer);
-    SendMessageToEFIX (g_XmtBuffer);
-    gpState = Send2ndSetupMessage_State; // SendSpeedAndDirection_State;
+        while (RS232_GetReceivedChar (&item))
+        {
+            ++g_ReceivedCounter;
+            if (ParseReceivedChar (item))
+            {
+                ProcessReply (g_RcvBuffer);
+            }
+        }
+
+        if ((os_tick_count_get() - g_LastReplyTime) >= MILLISECONDS_TO_TICKS(EFIX_REPLY_TIMEOUT_ms))
+        {
+            ReplyTimeout();
+        }
+    }
+
+    task_close();
 }
 
 //------------------------------------------------------------------------------
-// Function: Send1stSetupMessage_State
-// Description: This state sends the Maximum Speed Message to the eFix system and then
-//      sets the state to send a No Command Message
+// Function: IdleState
+// Description: Do nothing state. Essentially for debugging.
 //------------------------------------------------------------------------------
-static void Send2ndSetupMessage_State(void)
+int g_IdleStateCounter = 0;
+
+static void Idle_State (void)
 {
-    Create_eFix_2nd_Setup_Msg(g_XmtBuffer);
-    SendMessageToEFIX (g_XmtBuffer);
-    gpState = Send3rd_NoCommandMessage_State;
+    ++g_IdleStateCounter;
 }
 
 //------------------------------------------------------------------------------
-// Function: Send3rd_NoCommandMessage_State
-// Description: This state sends a NOP to the eFix system.
-// and then sets the state to send a the Speed and Direction state
+// Function: SendSetupSequence_State
+// Description: Sends the next step of the startup handshake in g_SetupSteps,
+//      and sets the wait before the step after it. After the last step the
+//      state is set to send the Speed and Direction.
 //------------------------------------------------------------------------------
-static void Send3rd_NoCommandMessage_State (void)
+static void SendSetupSequence_State (void)
 {
-    Create_NoCommand_Msg(g_XmtBuffer);
-    SendMessageToEFIX (g_XmtBuffer);
-    gpState = SendSpeedAndDirection_State;
+    const SetupStep_t *step = &g_SetupSteps[g_SetupStep];
+
+    if (g_SetupAckId != EFIX_REPLY_ID_NONE)
+    {
+        ++g_SetupAckTimeouts;       // Carry on, the eFix may not reply at all
+    }
+
+    SendMessageToEFIX (step->message);
+
+    g_SetupAckId = step->replyId;
+    g_eFixWaitTicks = MILLISECONDS_TO_TICKS(step->delay_ms);
+
+    if (++g_SetupStep >= NUM_SETUP_STEPS)
+    {
+        g_SetupAckId = EFIX_REPLY_ID_NONE;
+        gpState = SendSpeedAndDirection_State;
+    }
 }
 
 //------------------------------------------------------------------------------
 
 static void SendSpeedAndDirection_State (void)
 {
-    int i;
+    uint32_t now = os_tick_count_get();
+    uint8_t steps = 0;
+
+    // g_Speed and g_Direction are the demand. The ramp moves towards it once per
+    // ramp period, however often the messages go out. A settled ramp starts
+    // again at once, so a new command gets its first step in this message.
+    if (driveRampSettled())
+    {
+        g_RampTime = now - EFIX_RAMP_PERIOD_TICKS;
+    }
+    while ((now - g_RampTime) >= EFIX_RAMP_PERIOD_TICKS)
+    {
+        if (++steps > EFIX_RAMP_CATCH_UP_MAX)
+        {
+            g_RampTime = now;
+            break;
+        }
+        driveRampUpdate (g_Speed, g_Direction);
+        g_RampTime += EFIX_RAMP_PERIOD_TICKS;
+    }
+
+    // While the ramp moves, send each step. Once settled, only keep the eFix alive.
+    if (driveRampSettled())
+    {
+        g_eFixWaitTicks = MILLISECONDS_TO_TICKS(EFIX_COMM_TASK_DELAY);
+    }
+    else
+    {
+        g_eFixWaitTicks = (uint16_t)(g_RampTime + EFIX_RAMP_PERIOD_TICKS - now);
+    }
 
     // Create the Direction Message, eFix refers to this as "Steering".
-    Create_eFix_Steering_Message (g_XmtBuffer, g_Direction);
-    SendMessageToEFIX (g_XmtBuffer);
+    Create_eFix_Steering_Message (driveRampDirectionGet());
+    SendMessageToEFIX (g_SteeringMsg);
     // Create and send the speed message.
-    for (i=0; i<20; ++i)    // A little pause between each character
-        NOP();
-        
-    Create_eFix_Speed_Message (g_XmtBuffer, g_Speed);
-    SendMessageToEFIX (g_XmtBuffer);
+    Create_eFix_Speed_Message (driveRampSpeedGet());
+    SendMessageToEFIX (g_SpeedMsg);
     
     // TODO: Remove the following and allow the data to just repeatedly send
     // the speed and direction commands.
@@ -274,128 +507,151 @@ static void SendSpeedAndDirection_State (void)
 
 //------------------------------------------------------------------------------
 // Function: SendMessageToEFIX
-// Description: Send message this item in the buffer to the eFix controller via
-// RS-232.  Assumption is that the message is 6 character in length.
+// Description: Queue the message in the buffer to go to the eFix controller via
+// RS-232, and return at once. The transmit interrupt sends it, so the buffer
+// may be reused. Assumption is that the message is 6 character in length.
 //------------------------------------------------------------------------------
-static void SendMessageToEFIX (unsigned char *buffer)
+static void SendMessageToEFIX (const unsigned char *buffer)
 {
-    for (int counter = 0; counter < 6; ++counter)
+    if (RS232_TransmitFrame (buffer, EFIX_MSG_LENGTH) == false)
     {
-        while (RS232_TransmitReady() == false)       // Wait for transmit buffer to be ready to accept new character
-        {
-            ;
-        }
-        RS232_TransmitChar(buffer[counter]);
-    }
-    // Wait until character is transmitted. Without this, the process is interrupted and
-    // the final character is not sent out.
-    while (RS232_TransmitReady() == false)       // Wait for transmit buffer to be ready to accept new character
-    {
-        ;
+        // The ring only fills if the UART has stopped. The eFix then drops to
+        // neutral on its own, nothing better can be done here.
+        ++g_XmtDroppedCounter;
     }
 }
 //------------------------------------------------------------------------------
-// Function: CalcChecksum()
-// Description: This function calculates the checksum and puts in the 
-//      data to be sent to the eFix controller.
+// Function: ParseReceivedChar
+// Description: Adds a received character to the reply being collected. Characters
+//      before a SOT are skipped. A reply with a bad checksum is dropped, and the
+//      search for the next SOT goes on from the character after its SOT.
+// Returns: true if a good reply is in g_RcvBuffer
 //------------------------------------------------------------------------------
-void CalcChecksum(unsigned char *buffer)
+static bool ParseReceivedChar (unsigned char item)
 {
-    int checksum = 0;
+    uint8_t i;
+    uint8_t j;
 
-    for (int i = 0; i < 4; ++i)
-        checksum += buffer[i];
-    checksum = ~checksum;
-    checksum++;
-    buffer[4] = (unsigned char)(checksum >> 8);
-    buffer[5] = (unsigned char)(checksum & 0xff);
+    if ((g_RcvCount == 0) && (item != FROM_EFIX_SOT))
+    {
+        return false;
+    }
+
+    g_RcvBuffer[g_RcvCount++] = item;
+    if (g_RcvCount < EFIX_MSG_LENGTH)
+    {
+        return false;
+    }
+
+    g_RcvCount = 0;
+    if (ChecksumValid (g_RcvBuffer))
+    {
+        return true;
+    }
+
+    ++g_ReceiveChecksumErrors;
+    for (i = 1; i < EFIX_MSG_LENGTH; ++i)
+    {
+        if (g_RcvBuffer[i] == FROM_EFIX_SOT)
+        {
+            for (j = i; j < EFIX_MSG_LENGTH; ++j)
+            {
+                g_RcvBuffer[g_RcvCount++] = g_RcvBuffer[j];
+            }
+            break;
+        }
+    }
+    return false;
 }
 
 //------------------------------------------------------------------------------
-// This creates the blank, do nothing message.
+// Function: ChecksumValid
+// Description: Checks the 2 byte checksum of a message, see EFIX_CHECKSUM().
+// Returns: true if the checksum matches
 //------------------------------------------------------------------------------
-void Create_NoCommand_Msg(unsigned char *buffer)
+static bool ChecksumValid (const unsigned char *buffer)
 {
-    buffer[0] = TO_EFIX_SOT;     // Start of Transmission (SOT)
-    buffer[1] = 0x04;     // Message ID
-    buffer[2] = 0x00;
-    buffer[3] = 0x00;
-    CalcChecksum(buffer);
+    uint16_t sum = 0;
+
+    for (uint8_t i = 0; i < 4; ++i)
+        sum += buffer[i];
+    sum += ((uint16_t)buffer[4] << 8) | buffer[5];
+    return (sum == 0);      // The checksum is the negative of the sum
 }
 
 //------------------------------------------------------------------------------
-// This creates the 1st setup message that sets up the unit to use
-// the front panel speed pot.
+// Function: ProcessReply
+// Description: Publishes the status and error code of a good reply.
 //------------------------------------------------------------------------------
-static void Create_eFix_1st_Setup_Msg(unsigned char *buffer)
+static void ProcessReply (const unsigned char *buffer)
 {
-    buffer[0] = TO_EFIX_SOT; // 0xEB;     // Start of Transmission (SOT)
-    buffer[1] = 0x04;     // Message ID
-    buffer[2] = 0x40;       // Button Function byte
-                            // D6 1 = Light Function, D5 = on/off
-                            // D4 1 = Menu, D3 = Activate/Deactivate
-                            // D2 1 = Horn, D1 = on/off
-                            // D0 1 - Active Joystick Raw transmission
-    buffer[3] = 0x80;       // Special Function byte
-                            // 0x80 = Default Max Speed is via E3x control panel
-                            // 0xD0 = Default Max speed is via 0x08 cmd
-                            // 0xE0 = Drive commands through joystick in the E3x control panel.
-                            // 0xB0 = Drive commands via CMD's 0x01 and 0x02.
-    CalcChecksum (buffer);
+    bool ready = (buffer[EFIX_REPLY_STATUS_INDEX] == EFIX_REPLY_STATUS_READY);
+
+    g_LastReplyTime = os_tick_count_get();
+
+    if (ready)
+        ++g_Received55Counter;
+    if (ready && !g_eFixReady)
+        ++g_ReadyCounter;
+    else if (!ready && g_eFixReady)
+        ++g_NotReadyCounter;
+
+    g_eFixReady = ready;
+    g_eFixErrorCode = buffer[EFIX_REPLY_ERROR_INDEX];
+
+    // The setup message was taken, go on with the handshake. A reply to another
+    // message does not end the wait.
+    if ((g_SetupAckId != EFIX_REPLY_ID_NONE) && (buffer[EFIX_REPLY_ID_INDEX] == g_SetupAckId))
+    {
+        g_SetupAckId = EFIX_REPLY_ID_NONE;
+        WakeTask();
+    }
 }
 
 //------------------------------------------------------------------------------
-// This creates the setup message.
+// Function: ReplyTimeout
+// Description: No good reply came for EFIX_REPLY_TIMEOUT_ms. The eFix is not
+//      ready until it replies again.
 //------------------------------------------------------------------------------
-static void Create_eFix_2nd_Setup_Msg(unsigned char *buffer)
+static void ReplyTimeout (void)
 {
-    buffer[0] = TO_EFIX_SOT; // 0xEB;     // Start of Transmission (SOT)
-    buffer[1] = 0x04;     // Message ID
-    buffer[2] = 0x00;       // Button Function byte
-                            // D6 1 = Light Function, D5 = on/off
-                            // D4 1 = Menu, D3 = Activate/Deactivate
-                            // D2 1 = Horn, D1 = on/off
-                            // D0 1 - Active Joystick Raw transmission
-    buffer[3] = 0xB0;       // Special Function byte
-                            // 0x80 = Default Max Speed is via E3x control panel
-                            // 0xD0 = Default Max speed is via 0x08 cmd
-                            // 0xE0 = Drive commands through joystick in the E3x control panel.
-                            // 0xB0 = Drive commands via CMD's 0x01 and 0x02.
-    CalcChecksum (buffer);
+    ++g_ReceiveTimeout;
+    if (g_eFixReady)
+        ++g_NotReadyCounter;
+    g_eFixReady = false;
+    g_LastReplyTime = os_tick_count_get();  // Count once per timeout
 }
 
 //------------------------------------------------------------------------------
-// This creates the Maximum Speed message
+// Function: SetDrivePayload
+// Description: Writes a drive value, high byte first, into a message built by
+//      EFIX_MSG() with a payload of 0. Only the payload changes, so the checksum
+//      is the one of that neutral message less the 2 payload bytes.
 //------------------------------------------------------------------------------
-static void Create_eFix_MaxSpeed_Message(unsigned char *buffer)
+static void SetDrivePayload (unsigned char *buffer, uint16_t neutralChecksum, int value)
 {
-    buffer[0] = TO_EFIX_SOT;     // Start of Transmission (SOT)
-    buffer[1] = 0x08;     // Message ID
-    buffer[2] = 0x64;     // Only high byte
-    buffer[3] = 0x00;     // Only low byte
-    CalcChecksum(buffer);
+    unsigned char high = (unsigned char)(value >> 8);
+    unsigned char low = (unsigned char)(value & 0xff);
+    uint16_t checksum = neutralChecksum - high - low;
+
+    buffer[2] = high;
+    buffer[3] = low;
+    buffer[4] = (unsigned char)(checksum >> 8);
+    buffer[5] = (unsigned char)(checksum & 0xff);
 }
 
 //------------------------------------------------------------------------------
 // This creates the Direction (steering) message
 //------------------------------------------------------------------------------
-static void Create_eFix_Steering_Message (unsigned char *buffer, int direction)
+static void Create_eFix_Steering_Message (int direction)
 {
-    buffer[0] = TO_EFIX_SOT;     // Start of Transmission (SOT)
-    buffer[1] = 0x01;     // Message ID
-    buffer[2] = (direction >> 8);    // Only high byte
-    buffer[3] = (direction & 0xff);  // Only low byte
-    CalcChecksum(buffer);
+    SetDrivePayload (g_SteeringMsg, EFIX_CHECKSUM(TO_EFIX_SOT, EFIX_MSG_ID_STEERING, 0, 0), direction);
 }
 
 //------------------------------------------------------------------------------
 // This creates the Speed message
 //------------------------------------------------------------------------------
-static void Create_eFix_Speed_Message(unsigned char *buffer, int speed)
+static void Create_eFix_Speed_Message (int speed)
 {
-    buffer[0] = TO_EFIX_SOT;     // Start of Transmission (SOT)
-    buffer[1] = 0x02;     // Message ID
-    buffer[2] = (speed >> 8);    // Only high byte
-    buffer[3] = (speed & 0xff);  // Only low byte
-    CalcChecksum(buffer);
+    SetDrivePayload (g_SpeedMsg, EFIX_CHECKSUM(TO_EFIX_SOT, EFIX_MSG_ID_SPEED, 0, 0), speed);
 }
@@ -33,6 +33,7 @@
 #include "user_button.h"
 #include "head_array_bsp.h" // TODO: Expose MIN/MAX values in head_array driver module
 #include "head_array.h"
+#include "drive_ramp.h"
 #include "app_common.h"
 
 // from local
@@ -106,8 +107,23 @@
 // Version 6. Added Feature Byte 2 to accomodate RNet Sleep and Mode Switch schema
 #define MM_ENABLED_FEATURES_2						((uint8_t)MM_RIGHT_PAD_MIN_DRIVE_SPEED + ITEM_TYPE_UINT8_SIZE_BYTES)
 
+// Version 7. Added pad debounce times, in milliseconds.
+#define MM_PAD_ASSERT_TIME							((uint8_t)MM_ENABLED_FEATURES_2 + ITEM_TYPE_UINT8_SIZE_BYTES)
+#define MM_PAD_RELEASE_TIME							((uint8_t)MM_PAD_ASSERT_TIME + ITEM_TYPE_UINT8_SIZE_BYTES)
+
+// Version 8. Added drive ramp profiles, in percent per second and percent per second per second.
+#define MM_RAMP_FWD_ACCEL							((uint8_t)MM_PAD_RELEASE_TIME + ITEM_TYPE_UINT8_SIZE_BYTES)
+#define MM_RAMP_FWD_DECEL							((uint8_t)MM_RAMP_FWD_ACCEL + ITEM_TYPE_UINT8_SIZE_BYTES)
+#define MM_RAMP_FWD_JERK							((uint8_t)MM_RAMP_FWD_DECEL + ITEM_TYPE_UINT8_SIZE_BYTES)
+#define MM_RAMP_REV_ACCEL							((uint8_t)MM_RAMP_FWD_JERK + ITEM_TYPE_UINT8_SIZE_BYTES)
+#define MM_RAMP_REV_DECEL							((uint8_t)MM_RAMP_REV_ACCEL + ITEM_TYPE_UINT8_SIZE_BYTES)
+#define MM_RAMP_REV_JERK							((uint8_t)MM_RAMP_REV_DECEL + ITEM_TYPE_UINT8_SIZE_BYTES)
+#define MM_RAMP_TURN_ACCEL							((uint8_t)MM_RAMP_REV_JERK + ITEM_TYPE_UINT8_SIZE_BYTES)
+#define MM_RAMP_TURN_DECEL							((uint8_t)MM_RAMP_TURN_ACCEL + ITEM_TYPE_UINT8_SIZE_BYTES)
+#define MM_RAMP_TURN_JERK							((uint8_t)MM_RAMP_TURN_DECEL + ITEM_TYPE_UINT8_SIZE_BYTES)
+
 // Must be last item in this list. Denotes the total amount of real estate taken up in EEPROM.
-#define MM_NUM_BYTES								((uint8_t)MM_RIGHT_PAD_MIN_DRIVE_SPEED + ITEM_TYPE_UINT8_SIZE_BYTES)
+#define MM_NUM_BYTES								((uint8_t)MM_RAMP_TURN_JERK + ITEM_TYPE_UINT8_SIZE_BYTES)
 
 #endif // #ifdef ASL110
 
@@ -200,6 +216,21 @@ typedef struct
     // Added in EEPROM Version 6
     uint8_t enabled_features2;
     
+    // Added in EEPROM Version 7
+    uint8_t pad_assert_time_ms;
+    uint8_t pad_release_time_ms;
+    
+    // Added in EEPROM Version 8
+    uint8_t ramp_fwd_accel;
+    uint8_t ramp_fwd_decel;
+    uint8_t ramp_fwd_jerk;
+    uint8_t ramp_rev_accel;
+    uint8_t ramp_rev_decel;
+    uint8_t ramp_rev_jerk;
+    uint8_t ramp_turn_accel;
+    uint8_t ramp_turn_decel;
+    uint8_t ramp_turn_jerk;
+    
 } EepromDataItems_t;
 
 typedef union
@@ -314,7 +345,33 @@ static ItemInfo_t items_info[] =
 
     // Added in Version 6
     // EEPROM_STORED_ITEM_ENABLED_FEATURES_2
-	{ITEM_TYPE_UINT8,		MM_ENABLED_FEATURES_2,						false}
+	{ITEM_TYPE_UINT8,		MM_ENABLED_FEATURES_2,						false},
+
+    // Added in Version 7
+    // EEPROM_STORED_ITEM_PAD_ASSERT_TIME
+	{ITEM_TYPE_UINT8,		MM_PAD_ASSERT_TIME,							false},
+    // EEPROM_STORED_ITEM_PAD_RELEASE_TIME
+	{ITEM_TYPE_UINT8,		MM_PAD_RELEASE_TIME,						false},
+
+    // Added in Version 8
+    // EEPROM_STORED_ITEM_RAMP_FWD_ACCEL
+	{ITEM_TYPE_UINT8,		MM_RAMP_FWD_ACCEL,							false},
+    // EEPROM_STORED_ITEM_RAMP_FWD_DECEL
+	{ITEM_TYPE_UINT8,		MM_RAMP_FWD_DECEL,							false},
+    // EEPROM_STORED_ITEM_RAMP_FWD_JERK
+	{ITEM_TYPE_UINT8,		MM_RAMP_FWD_JERK,							false},
+    // EEPROM_STORED_ITEM_RAMP_REV_ACCEL
+	{ITEM_TYPE_UINT8,		MM_RAMP_REV_ACCEL,							false},
+    // EEPROM_STORED_ITEM_RAMP_REV_DECEL
+	{ITEM_TYPE_UINT8,		MM_RAMP_REV_DECEL,							false},
+    // EEPROM_STORED_ITEM_RAMP_REV_JERK
+	{ITEM_TYPE_UINT8,		MM_RAMP_REV_JERK,							false},
+    // EEPROM_STORED_ITEM_RAMP_TURN_ACCEL
+	{ITEM_TYPE_UINT8,		MM_RAMP_TURN_ACCEL,							false},
+    // EEPROM_STORED_ITEM_RAMP_TURN_DECEL
+	{ITEM_TYPE_UINT8,		MM_RAMP_TURN_DECEL,							false},
+    // EEPROM_STORED_ITEM_RAMP_TURN_JERK
+	{ITEM_TYPE_UINT8,		MM_RAMP_TURN_JERK,							false}
 };
 #endif // #ifdef ASL110
 
@@ -410,6 +467,25 @@ bool eepromAppInit(void)
                 EEPROM_Version = 6; // This allows any further updating to occur
             }
             if (EEPROM_Version == 6)
+            {
+                eeprom8bitSet (EEPROM_STORED_ITEM_PAD_ASSERT_TIME, HEAD_ARRAY_PAD_ASSERT_TIME_DEFAULT_ms);
+                eeprom8bitSet (EEPROM_STORED_ITEM_PAD_RELEASE_TIME, HEAD_ARRAY_PAD_RELEASE_TIME_DEFAULT_ms);
+                EEPROM_Version = 7;
+            }
+            if (EEPROM_Version == 7)
+            {
+                eeprom8bitSet (EEPROM_STORED_ITEM_RAMP_FWD_ACCEL, DRIVE_RAMP_FWD_ACCEL_DEFAULT);
+                eeprom8bitSet (EEPROM_STORED_ITEM_RAMP_FWD_DECEL, DRIVE_RAMP_FWD_DECEL_DEFAULT);
+                eeprom8bitSet (EEPROM_STORED_ITEM_RAMP_FWD_JERK, DRIVE_RAMP_FWD_JERK_DEFAULT);
+                eeprom8bitSet (EEPROM_STORED_ITEM_RAMP_REV_ACCEL, DRIVE_RAMP_REV_ACCEL_DEFAULT);
+                eeprom8bitSet (EEPROM_STORED_ITEM_RAMP_REV_DECEL, DRIVE_RAMP_REV_DECEL_DEFAULT);
+                eeprom8bitSet (EEPROM_STORED_ITEM_RAMP_REV_JERK, DRIVE_RAMP_REV_JERK_DEFAULT);
+                eeprom8bitSet (EEPROM_STORED_ITEM_RAMP_TURN_ACCEL, DRIVE_RAMP_TURN_ACCEL_DEFAULT);
+                eeprom8bitSet (EEPROM_STORED_ITEM_RAMP_TURN_DECEL, DRIVE_RAMP_TURN_DECEL_DEFAULT);
+                eeprom8bitSet (EEPROM_STORED_ITEM_RAMP_TURN_JERK, DRIVE_RAMP_TURN_JERK_DEFAULT);
+                EEPROM_Version = 8;
+            }
+            if (EEPROM_Version == 8)
             {
                 ; // Nothing to do
             }
@@ -729,18 +805,18 @@ void SetDefaultValues(void)
 
 	eeprom_data.items.left_pad_min_adc_val = ADC_LEFT_PAD_MIN_VAL;
 	eeprom_data.items.left_pad_max_adc_val = ADC_LEFT_PAD_MAX_VAL;
-	eeprom_data.items.left_pad_min_thresh_perc = 2;
-	eeprom_data.items.left_pad_max_thresh_perc = 30;
+	eeprom_data.items.left_pad_min_thresh_perc = HEAD_ARRAY_PAD_MIN_THRESH_PERC_DEFAULT;
+	eeprom_data.items.left_pad_max_thresh_perc = HEAD_ARRAY_PAD_MAX_THRESH_PERC_DEFAULT;
 
 	eeprom_data.items.right_pad_min_adc_val = ADC_RIGHT_PAD_MIN_VAL;
 	eeprom_data.items.right_pad_max_adc_val = ADC_RIGHT_PAD_MAX_VAL;
-	eeprom_data.items.right_pad_min_thresh_perc = 2;
-	eeprom_data.items.right_pad_max_thresh_perc = 30;
+	eeprom_data.items.right_pad_min_thresh_perc = HEAD_ARRAY_PAD_MIN_THRESH_PERC_DEFAULT;
+	eeprom_data.items.right_pad_max_thresh_perc = HEAD_ARRAY_PAD_MAX_THRESH_PERC_DEFAULT;
 
 	eeprom_data.items.ctr_pad_min_adc_val = ADC_CTR_PAD_MIN_VAL;
 	eeprom_data.items.ctr_pad_max_adc_val = ADC_CTR_PAD_MAX_VAL;
-	eeprom_data.items.ctr_pad_min_thresh_perc = 2;
-	eeprom_data.items.ctr_pad_max_thresh_perc = 30;
+	eeprom_data.items.ctr_pad_min_thresh_perc = HEAD_ARRAY_PAD_MIN_THRESH_PERC_DEFAULT;
+	eeprom_data.items.ctr_pad_max_thresh_perc = HEAD_ARRAY_PAD_MAX_THRESH_PERC_DEFAULT;
 
 #ifdef USE_12VOLT_REGULATOR
     eeprom_data.items.neutral_DAC_counts = 2048+212;        // Mid-point of 12-bit DAC
@@ -765,6 +841,21 @@ void SetDefaultValues(void)
     
     // Added in Version 6
     eeprom_data.items.enabled_features2 = 0;                // Feature set 2 is all disabled.
+
+    // Added in Version 7
+    eeprom_data.items.pad_assert_time_ms = HEAD_ARRAY_PAD_ASSERT_TIME_DEFAULT_ms;
+    eeprom_data.items.pad_release_time_ms = HEAD_ARRAY_PAD_RELEASE_TIME_DEFAULT_ms;
+
+    // Added in Version 8
+    eeprom_data.items.ramp_fwd_accel = DRIVE_RAMP_FWD_ACCEL_DEFAULT;
+    eeprom_data.items.ramp_fwd_decel = DRIVE_RAMP_FWD_DECEL_DEFAULT;
+    eeprom_data.items.ramp_fwd_jerk = DRIVE_RAMP_FWD_JERK_DEFAULT;
+    eeprom_data.items.ramp_rev_accel = DRIVE_RAMP_REV_ACCEL_DEFAULT;
+    eeprom_data.items.ramp_rev_decel = DRIVE_RAMP_REV_DECEL_DEFAULT;
+    eeprom_data.items.ramp_rev_jerk = DRIVE_RAMP_REV_JERK_DEFAULT;
+    eeprom_data.items.ramp_turn_accel = DRIVE_RAMP_TURN_ACCEL_DEFAULT;
+    eeprom_data.items.ramp_turn_decel = DRIVE_RAMP_TURN_DECEL_DEFAULT;
+    eeprom_data.items.ramp_turn_jerk = DRIVE_RAMP_TURN_JERK_DEFAULT;
 }
 #endif // #ifdef ASL110
 
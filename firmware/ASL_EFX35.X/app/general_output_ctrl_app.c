@@ -73,7 +73,7 @@
 /************************************ Symbolic Constants **********************************/
 #define MIN_TIME_FOR_SUBSTATE_ms (GENERAL_OUTPUT_CTRL_UPDATE_RATE_ms)
 
-#define STATE_CHANGE_REQ_CIRC_BUF_NUM_SLOTS (3)
+#define STATE_CHANGE_REQ_RING_NUM_SLOTS (4) // Must be a power of 2
 
 /*
  **************************************************************************************************
@@ -99,10 +99,8 @@ typedef struct
 
 #ifdef OK_TO_USE_CONTROL_SCHEME
 
-static volatile unsigned int state_change_req_circ_buf_pos_head = 0;
-static volatile unsigned int state_change_req_circ_buf_pos_tail = 0;
-static volatile unsigned int state_change_req_circ_buf_slots_in_use = 0;
-static StateCtrl_t state_change_req_circ_buf[STATE_CHANGE_REQ_CIRC_BUF_NUM_SLOTS];
+static Ring_t state_change_req_ring;
+static StateCtrl_t state_change_req_ring_buf[STATE_CHANGE_REQ_RING_NUM_SLOTS];
 
 /// @brief Event that wakes up this module's task if it needs to to something useful.
 static volatile Evt_t os_event_wake_task_id;
@@ -288,6 +286,8 @@ bool GenOutCtrlApp_Init(void)
     GenOutCtrl_AppRtosCb_MutexUnlock_Set((GenOutCtrl_AppCbFunc_t)NULL);
 #endif
 
+    ring_init(&state_change_req_ring, state_change_req_ring_buf, STATE_CHANGE_REQ_RING_NUM_SLOTS, sizeof(StateCtrl_t), NO_EVENT);
+
     os_event_wake_task_id = event_create();
 
     // Create the state update and control task
@@ -306,16 +306,13 @@ bool GenOutCtrlApp_Init(void)
  */
 void GenOutCtrlApp_SetStateAll(GenOutState_t ctrlr_state)
 {
-    if (state_change_req_circ_buf_slots_in_use < STATE_CHANGE_REQ_CIRC_BUF_NUM_SLOTS)
-    {
-        state_change_req_circ_buf[state_change_req_circ_buf_pos_tail].set_all = true;
-        state_change_req_circ_buf[state_change_req_circ_buf_pos_tail].id = GEN_OUT_CTRL_ID_MAX;
-        state_change_req_circ_buf[state_change_req_circ_buf_pos_tail].state = ctrlr_state;
+    StateCtrl_t state_change_req;
 
-        state_change_req_circ_buf_slots_in_use++;
-        state_change_req_circ_buf_pos_tail = (state_change_req_circ_buf_pos_tail == (STATE_CHANGE_REQ_CIRC_BUF_NUM_SLOTS - 1)) ? 0 : (state_change_req_circ_buf_pos_tail + 1);
-    }
-    else
+    state_change_req.set_all = true;
+    state_change_req.id = GEN_OUT_CTRL_ID_MAX;
+    state_change_req.state = ctrlr_state;
+
+    if (!ring_push(&state_change_req_ring, &state_change_req))
     {
         ASSERT(false);
     }
@@ -329,16 +326,13 @@ void GenOutCtrlApp_SetStateAll(GenOutState_t ctrlr_state)
  */
 void GenOutCtrlApp_SetState(GenOutCtrlId_t item_id, GenOutState_t ctrlr_state)
 {
-    if (state_change_req_circ_buf_slots_in_use < STATE_CHANGE_REQ_CIRC_BUF_NUM_SLOTS)
-    {
-        state_change_req_circ_buf[state_change_req_circ_buf_pos_tail].set_all = false;
-        state_change_req_circ_buf[state_change_req_circ_buf_pos_tail].id = item_id;
-        state_change_req_circ_buf[state_change_req_circ_buf_pos_tail].state = ctrlr_state;
+    StateCtrl_t state_change_req;
 
-        state_change_req_circ_buf_slots_in_use++;
-        state_change_req_circ_buf_pos_tail = (state_change_req_circ_buf_pos_tail == (STATE_CHANGE_REQ_CIRC_BUF_NUM_SLOTS - 1)) ? 0 : (state_change_req_circ_buf_pos_tail + 1);
-    }
-    else
+    state_change_req.set_all = false;
+    state_change_req.id = item_id;
+    state_change_req.state = ctrlr_state;
+
+    if (!ring_push(&state_change_req_ring, &state_change_req))
     {
         ASSERT(false);
     }
@@ -378,6 +372,8 @@ Evt_t genOutCtrlAppWakeEvent(void)
 
 static void ControlTask(void)
 {
+    StateCtrl_t state_change_req;
+
     task_open();
     
     // Service any state change requests that may be pending.
@@ -386,12 +382,9 @@ static void ControlTask(void)
     // NOTE: We do this check here as tasks that run before this one on boot
     // NOTE: may request state changes where the event will be "sent" but thrown away by the
     // NOTE: OS kernel.
-    while (state_change_req_circ_buf_slots_in_use > 0)
+    while (ring_pop(&state_change_req_ring, &state_change_req))
     {
-        SetOutputControllersToNewState(&state_change_req_circ_buf[state_change_req_circ_buf_pos_head]);
-
-        state_change_req_circ_buf_slots_in_use--;
-        state_change_req_circ_buf_pos_head = (state_change_req_circ_buf_pos_head == (STATE_CHANGE_REQ_CIRC_BUF_NUM_SLOTS - 1)) ? 0 : (state_change_req_circ_buf_pos_head + 1);
+        SetOutputControllersToNewState(&state_change_req);
     }
     
     StopWatch_t task_time_elapsed_sw;
@@ -411,12 +404,9 @@ static void ControlTask(void)
         
         // Service any state change requests that may be pending.
         // We'll have control of the OS through this entire loop. Run through all requested state changes
-        while (state_change_req_circ_buf_slots_in_use > 0)
+        while (ring_pop(&state_change_req_ring, &state_change_req))
         {
-            SetOutputControllersToNewState(&state_change_req_circ_buf[state_change_req_circ_buf_pos_head]);
-
-            state_change_req_circ_buf_slots_in_use--;
-            state_change_req_circ_buf_pos_head = (state_change_req_circ_buf_pos_head == (STATE_CHANGE_REQ_CIRC_BUF_NUM_SLOTS - 1)) ? 0 : (state_change_req_circ_buf_pos_head + 1);
+            SetOutputControllersToNewState(&state_change_req);
         }
 
         // Turn the BLUE Bluetooth LED on/off based upon the Bluetooth feature
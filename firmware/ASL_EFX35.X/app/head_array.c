@@ -37,6 +37,7 @@
 #include "general_output_ctrl_bsp.h"
 #include "app_common.h"
 #include "beeper.h"
+#include "MainState.h"
 
 // from local
 #include "head_array_bsp.h"
@@ -44,19 +45,73 @@
 
 /* ******************************   Macros   ****************************** */
 
+// While a pad is being debounced it is sampled at this rate, in milliseconds.
+#define PAD_DEBOUNCE_SAMPLE_ms      (2)
+
+// Bits of the debounce count, the assert and release times are at most
+// PAD_DEBOUNCE_COUNT_MAX samples.
+#define PAD_DEBOUNCE_COUNT_BITS     (4)
+#define PAD_DEBOUNCE_COUNT_MAX      ((1 << PAD_DEBOUNCE_COUNT_BITS) - 1)
+
+#define HEAD_ARRAY_PADS_ALL         ((uint8_t)((1 << HEAD_ARRAY_SENSOR_EOL) - 1))
+
+// Proportional pads are read at this rate, in milliseconds, while none is being debounced.
+// A scan of all pads takes about 1.5 ms, the task reads what it has after the timeout.
+#define PAD_PROP_SAMPLE_ms          (20)
+#define PAD_SCAN_TIMEOUT_ms         (5)
+
+// Full drive demand, in percent, and in the 16.16 fixed point of PadScale_t.gain.
+#define PAD_PERCENT_MAX             (100)
+#define PAD_PERCENT_Q16             ((uint32_t)PAD_PERCENT_MAX << 16)
+
+/* ******************************   Types   ******************************* */
+
+// Calibration of a proportional pad. The drive demand is 0 up to low, then rises by gain
+// for each count above low, and is PAD_PERCENT_MAX from low + span on.
+typedef struct
+{
+    uint16_t low;       // Reading at the minimum threshold
+    uint16_t span;      // Readings from the minimum to the maximum threshold
+    uint32_t gain;      // Percent per count, 16.16 fixed point
+} PadScale_t;
+
 /* ***********************   File Scope Variables   *********************** */
 
-struct 
+static uint8_t g_Pads = 0;      // Active pads from the last reading, see HEAD_ARRAY_PAD_BIT()
+
+// Pad debounce. The count of each pad is kept as a vertical counter: bit n of
+// g_DebounceCount[k] is bit k of the count of pad n, so all pads are filtered at once
+// with a few byte operations. The thresholds are kept the same way.
+static uint8_t g_DebouncedPads = 0;
+static uint8_t g_DebounceCount[PAD_DEBOUNCE_COUNT_BITS];
+static uint8_t g_AssertCount[PAD_DEBOUNCE_COUNT_BITS];     // Samples to take an inactive pad as active
+static uint8_t g_ReleaseCount[PAD_DEBOUNCE_COUNT_BITS];    // Samples to take an active pad as inactive
+
+// Proportional pads, in HeadArraySensor_t order
+static PadScale_t g_PadScale[HEAD_ARRAY_SENSOR_EOL];
+static uint16_t g_PadRaw[HEAD_ARRAY_SENSOR_EOL];        // Last reading
+static uint8_t g_PadPercent[HEAD_ARRAY_SENSOR_EOL];     // Drive demand of the last reading, percent
+
+// LED of each pad, in HeadArraySensor_t order.
+static const GenOutCtrlId_t g_PadLedId[HEAD_ARRAY_SENSOR_EOL] =
 {
-    bool m_CurrentPadStatus;
-    bool m_PreviousPadStatus;
-    GenOutCtrlId_t m_LED_ID;
-} g_PadInfo[HEAD_ARRAY_SENSOR_EOL];
+    GEN_OUT_CTRL_ID_LEFT_PAD_LED,
+    GEN_OUT_CTRL_ID_RIGHT_PAD_LED,
+    GEN_OUT_CTRL_ID_FORWARD_PAD_LED,
+    GEN_OUT_CTRL_ID_REVERSE_PAD_LED
+};
+
+static DeadlineId_t g_HeadArrayTaskDeadlineID;
+
+// Pad edges, set by headArrayPadEdgeIsr() and cleared by the task once it has read the pads.
+static Evt_t g_PadEdgeEvent;
+static volatile bool g_PadEdgePending = false;
+static volatile uint32_t g_PadEdgeTime;         // OS tick of the first edge not read yet
+static uint32_t g_PadEdgeLatencyMax = 0;        // Longest time from an edge to the pads being read, OS ticks
 
 
 /* ***********************   Function Prototypes   ************************ */
 
-static void HeadArrayInputControlTask(void);
 
 //static void MirrorUpdateDigitalInputValues(void);
 //static void MirrorUpdateProportionalInputValues(void);
@@ -65,6 +120,13 @@ static void HeadArrayInputControlTask(void);
 //static bool SyncWithEeprom(void);
 //static void RefreshLimits(void);
 
+static uint8_t DebouncePads(uint8_t raw_pads);
+static uint8_t DebounceCountingPads(void);
+static uint8_t DebounceSamples(uint8_t time_ms);
+#ifdef HEAD_ARRAY_PROPORTIONAL_PADS
+static bool ScalePads(uint8_t *raw_pads);
+#endif
+
 #if defined(TEST_BASIC_DAC_CONTROL)
 	static void TestBasicDacControl(void);
 #endif
@@ -80,27 +142,45 @@ static void HeadArrayInputControlTask(void);
 void headArrayinit(void)
 {
 	// Initialize other data
-	for (int i = 0; i < (int)HEAD_ARRAY_SENSOR_EOL; i++)
-	{
-//		pad_dig_state[i] = false;
-//		pad_prop_state[i] = PROP_UNINITIALIZED_VAL;
-//		pad_raw_prop_state[i] = PROP_UNINITIALIZED_VAL;
-        g_PadInfo[i].m_CurrentPadStatus = false;
-        g_PadInfo[i].m_PreviousPadStatus = false;
-	}
-    g_PadInfo[HEAD_ARRAY_SENSOR_LEFT].m_LED_ID = GEN_OUT_CTRL_ID_LEFT_PAD_LED;
-    g_PadInfo[HEAD_ARRAY_SENSOR_RIGHT].m_LED_ID = GEN_OUT_CTRL_ID_RIGHT_PAD_LED;
-    g_PadInfo[HEAD_ARRAY_SENSOR_CENTER].m_LED_ID = GEN_OUT_CTRL_ID_FORWARD_PAD_LED;
-    g_PadInfo[HEAD_ARRAY_SENSOR_BACK].m_LED_ID = GEN_OUT_CTRL_ID_REVERSE_PAD_LED;
+    g_Pads = 0;
     
+    g_PadEdgeEvent = event_create();
+
 	// Initialize all submodules controlled by this module.
 	headArrayBspInit();
 	bluetoothSimpleIfBspInit();
     
 	// Fetch initial values from the EEPROM
 //	(void)SyncWithEeprom();
+#ifdef ASL110
+    headArrayDebounceTimesSet(eeprom8bitGet(EEPROM_STORED_ITEM_PAD_ASSERT_TIME), eeprom8bitGet(EEPROM_STORED_ITEM_PAD_RELEASE_TIME));
+#else
+    headArrayDebounceTimesSet(HEAD_ARRAY_PAD_ASSERT_TIME_DEFAULT_ms, HEAD_ARRAY_PAD_RELEASE_TIME_DEFAULT_ms);
+#endif
+
+#ifdef ASL110
+    headArrayPadCalibrationSet(HEAD_ARRAY_SENSOR_LEFT,
+            eeprom16bitGet(EEPROM_STORED_ITEM_LEFT_PAD_MIN_ADC_VAL), eeprom16bitGet(EEPROM_STORED_ITEM_LEFT_PAD_MAX_ADC_VAL),
+            eeprom16bitGet(EEPROM_STORED_ITEM_LEFT_PAD_MIN_THRESH_PERC), eeprom16bitGet(EEPROM_STORED_ITEM_LEFT_PAD_MAX_THRESH_PERC));
+    headArrayPadCalibrationSet(HEAD_ARRAY_SENSOR_RIGHT,
+            eeprom16bitGet(EEPROM_STORED_ITEM_RIGHT_PAD_MIN_ADC_VAL), eeprom16bitGet(EEPROM_STORED_ITEM_RIGHT_PAD_MAX_ADC_VAL),
+            eeprom16bitGet(EEPROM_STORED_ITEM_RIGHT_PAD_MIN_THRESH_PERC), eeprom16bitGet(EEPROM_STORED_ITEM_RIGHT_PAD_MAX_THRESH_PERC));
+    headArrayPadCalibrationSet(HEAD_ARRAY_SENSOR_CENTER,
+            eeprom16bitGet(EEPROM_STORED_ITEM_CTR_PAD_MIN_ADC_VAL), eeprom16bitGet(EEPROM_STORED_ITEM_CTR_PAD_MAX_ADC_VAL),
+            eeprom16bitGet(EEPROM_STORED_ITEM_CTR_PAD_MIN_THRESH_PERC), eeprom16bitGet(EEPROM_STORED_ITEM_CTR_PAD_MAX_THRESH_PERC));
+#else
+    headArrayPadCalibrationSet(HEAD_ARRAY_SENSOR_LEFT, ADC_LEFT_PAD_MIN_VAL, ADC_LEFT_PAD_MAX_VAL,
+            HEAD_ARRAY_PAD_MIN_THRESH_PERC_DEFAULT, HEAD_ARRAY_PAD_MAX_THRESH_PERC_DEFAULT);
+    headArrayPadCalibrationSet(HEAD_ARRAY_SENSOR_RIGHT, ADC_RIGHT_PAD_MIN_VAL, ADC_RIGHT_PAD_MAX_VAL,
+            HEAD_ARRAY_PAD_MIN_THRESH_PERC_DEFAULT, HEAD_ARRAY_PAD_MAX_THRESH_PERC_DEFAULT);
+    headArrayPadCalibrationSet(HEAD_ARRAY_SENSOR_CENTER, ADC_CTR_PAD_MIN_VAL, ADC_CTR_PAD_MAX_VAL,
+            HEAD_ARRAY_PAD_MIN_THRESH_PERC_DEFAULT, HEAD_ARRAY_PAD_MAX_THRESH_PERC_DEFAULT);
+#endif
+    // There is no stored calibration for the back pad.
+    headArrayPadCalibrationSet(HEAD_ARRAY_SENSOR_BACK, ADC_BACK_PAD_MIN_VAL, ADC_BACK_PAD_MAX_VAL,
+            HEAD_ARRAY_PAD_MIN_THRESH_PERC_DEFAULT, HEAD_ARRAY_PAD_MAX_THRESH_PERC_DEFAULT);
 
-    (void)task_create(HeadArrayInputControlTask, NULL, HEAD_ARR_MGMT_TASK_PRIO, NULL, 0, 0);
+    g_HeadArrayTaskDeadlineID = AppCommonDeadlineRegister(HEAD_ARRAY_TASK_DELAY, HEAD_ARRAY_TASK_DEADLINE, NULL);
 }
 
 //------------------------------------------------------------------------------
@@ -114,7 +194,104 @@ void headArrayinit(void)
 //------------------------------------------------------------------------------
 bool headArrayDigitalInputValue(HeadArraySensor_t sensor)
 {
-	return g_PadInfo[sensor].m_CurrentPadStatus;
+	return ((g_Pads & HEAD_ARRAY_PAD_BIT(sensor)) != 0);
+}
+
+//------------------------------------------------------------------------------
+// Function: headArrayDigitalInputs
+//
+// Description: Returns all digital sensor inputs from the last reading as a bitmask,
+//      see HEAD_ARRAY_PAD_BIT(). All pads were sampled at the same instant.
+//
+//------------------------------------------------------------------------------
+uint8_t headArrayDigitalInputs(void)
+{
+	return g_Pads;
+}
+
+//------------------------------------------------------------------------------
+// Function: headArrayDebounceTimesSet
+//
+// Description: Sets how long a pad must be seen active before it is taken as active,
+//      and inactive before it is taken as inactive, in milliseconds. The times are
+//      rounded to the debounce sample rate and limited to PAD_DEBOUNCE_COUNT_MAX
+//      samples. 0 turns the filter off.
+//
+//------------------------------------------------------------------------------
+void headArrayDebounceTimesSet(uint8_t assert_ms, uint8_t release_ms)
+{
+    uint8_t assert_samples = DebounceSamples(assert_ms);
+    uint8_t release_samples = DebounceSamples(release_ms);
+
+    for (int k = 0; k < PAD_DEBOUNCE_COUNT_BITS; k++)
+    {
+        g_AssertCount[k] = (assert_samples & (1 << k)) ? HEAD_ARRAY_PADS_ALL : 0;
+        g_ReleaseCount[k] = (release_samples & (1 << k)) ? HEAD_ARRAY_PADS_ALL : 0;
+        g_DebounceCount[k] = 0;     // A count may be past the new threshold
+    }
+}
+
+//------------------------------------------------------------------------------
+// Function: headArrayProportionalInputValue
+//
+// Description: Returns the drive demand of a pad from the last reading, 0 to 100 percent.
+//      A digital pad is 0 or 100. An inactive pad is always 0.
+//
+//------------------------------------------------------------------------------
+uint8_t headArrayProportionalInputValue(HeadArraySensor_t sensor)
+{
+    if ((g_Pads & HEAD_ARRAY_PAD_BIT(sensor)) == 0)
+    {
+        return 0;
+    }
+#ifdef HEAD_ARRAY_PROPORTIONAL_PADS
+    return g_PadPercent[sensor];
+#else
+    return PAD_PERCENT_MAX;
+#endif
+}
+
+//------------------------------------------------------------------------------
+// Function: headArrayProportionalInputValueRaw
+//
+// Description: Returns the last reading of a proportional pad, 0 to HEAD_ARRAY_BSP_PROP_MAX.
+//
+//------------------------------------------------------------------------------
+uint16_t headArrayProportionalInputValueRaw(HeadArraySensor_t sensor)
+{
+    return g_PadRaw[sensor];
+}
+
+//------------------------------------------------------------------------------
+// Function: headArrayPadCalibrationSet
+//
+// Description: Sets the calibration of a proportional pad. min_adc and max_adc are the
+//      readings of the released and the fully pressed pad. The pad is inactive up to
+//      min_thresh_perc of that range, and gives full drive demand from max_thresh_perc.
+//      The scaling is worked out here, so that a reading only takes a multiply.
+//
+//------------------------------------------------------------------------------
+void headArrayPadCalibrationSet(HeadArraySensor_t sensor, uint16_t min_adc, uint16_t max_adc, uint16_t min_thresh_perc, uint16_t max_thresh_perc)
+{
+    PadScale_t *scale;
+    uint16_t range;
+
+    ASSERT(sensor < HEAD_ARRAY_SENSOR_EOL);
+    scale = &g_PadScale[sensor];
+
+    if (max_thresh_perc > PAD_PERCENT_MAX)
+    {
+        max_thresh_perc = PAD_PERCENT_MAX;
+    }
+    if (min_thresh_perc > max_thresh_perc)
+    {
+        min_thresh_perc = max_thresh_perc;
+    }
+    range = (max_adc > min_adc) ? (max_adc - min_adc) : 0;
+
+    scale->low = min_adc + (uint16_t)(((uint32_t)range * min_thresh_perc) / PAD_PERCENT_MAX);
+    scale->span = (uint16_t)(((uint32_t)range * (max_thresh_perc - min_thresh_perc)) / PAD_PERCENT_MAX);
+    scale->gain = (scale->span != 0) ? ((PAD_PERCENT_Q16 + (scale->span / 2)) / scale->span) : 0;
 }
 
 //------------------------------------------------------------------------------
@@ -131,106 +308,162 @@ bool headArrayPadIsConnected(HeadArraySensor_t sensor)
 }
 
 
+//------------------------------------------------------------------------------
+// Function: headArrayPadEdgeIsr
+//
+// Description: Wakes the head array task when a pad changes. Called from the low
+//      priority ISR.
+//
+// NOTE: While the CPU idles with a long tick period, the OS tick count is behind until
+// NOTE: the tick ISR credits the idle ticks, and so is the edge time. The task reads the
+// NOTE: same count, so the latency is still right.
+//
+//------------------------------------------------------------------------------
+void headArrayPadEdgeIsr(void)
+{
+    if (!g_PadEdgePending)
+    {
+        g_PadEdgeTime = os_tick_count_get();
+        g_PadEdgePending = true;
+    }
+    event_ISR_signal(g_PadEdgeEvent);
+}
+
+//------------------------------------------------------------------------------
+// Function: headArrayPadEdgeLatencyMaxGet
+//
+// Description: Returns the longest time from a pad edge until the head array task
+//      read the pads, in OS ticks.
+//
+//------------------------------------------------------------------------------
+uint32_t headArrayPadEdgeLatencyMaxGet(void)
+{
+    return g_PadEdgeLatencyMax;
+}
+
+
+//------------------------------------------------------------------------------
+// Function: headArrayPadScanIsr
+//
+// Description: Wakes the head array task at the end of a scan of the proportional
+//      pads. Called from the low priority ISR.
+//
+//------------------------------------------------------------------------------
+void headArrayPadScanIsr(void)
+{
+    event_ISR_signal(g_PadEdgeEvent);
+}
+
+
 /* ********************   Private Function Definitions   ****************** */
 
 //------------------------------------------------------------------------------
 // Function: HeadArrayInputControlTask
 //
-// Description: Does as the name suggests.
+// Description: Does as the name suggests. Runs when a pad edge interrupt signals
+//      g_PadEdgeEvent, and at least every HEAD_ARRAY_TASK_DELAY for a pad without
+//      an edge interrupt, see head_array_bsp.c. Proportional pads are scanned every
+//      PAD_PROP_SAMPLE_ms instead.
 //
 //------------------------------------------------------------------------------
-static void HeadArrayInputControlTask(void)
+void HeadArrayInputControlTask(void)
 {
     task_open();
 //	void (*myState)(void);
     
 	bool outputs_are_off = false;
 	StopWatch_t neutral_sw;
+    uint8_t pads;
+    uint8_t changed;
+    uint8_t pad_bit;
+    bool demand_changed;
+    uint32_t latency;
 
 	while (1)
 	{
-        // Get the current status of all pads
-        for (int sensor_id = 0; sensor_id < (int)HEAD_ARRAY_SENSOR_EOL; sensor_id++)
+        // Locals are not kept across a wait, set them again every time around.
+        demand_changed = false;
+
+        // The ISR does not touch the edge time while an edge is pending.
+        if (g_PadEdgePending)
         {
-            g_PadInfo[sensor_id].m_CurrentPadStatus = headArrayBspDigitalState((HeadArraySensor_t)sensor_id);
+            latency = os_tick_count_get() - g_PadEdgeTime;
+            if (latency > g_PadEdgeLatencyMax)
+            {
+                g_PadEdgeLatencyMax = latency;
+            }
+            g_PadEdgePending = false;
         }
+
+        // Get the current status of all pads
+#ifdef HEAD_ARRAY_PROPORTIONAL_PADS
+        // Convert all pads, the ADC ISR signals the end of the scan. A scan that ends
+        // before the wait is set up does not wait.
+        headArrayBspScanStart();
+        event_wait_timeout_unless(g_PadEdgeEvent, MILLISECONDS_TO_TICKS(PAD_SCAN_TIMEOUT_ms), headArrayBspScanDone());
+        demand_changed = ScalePads(&pads);
+        pads = DebouncePads(pads);
+#else
+        pads = DebouncePads(headArrayBspDigitalStates());
+#endif
         
         // Prevent the Right and Left pads active at the same time.
         // This is a safety feature.
-        if (g_PadInfo[HEAD_ARRAY_SENSOR_LEFT].m_CurrentPadStatus && g_PadInfo[HEAD_ARRAY_SENSOR_RIGHT].m_CurrentPadStatus)
+        if ((pads & HEAD_ARRAY_PADS_LEFT_RIGHT) == HEAD_ARRAY_PADS_LEFT_RIGHT)
         {
-            g_PadInfo[HEAD_ARRAY_SENSOR_LEFT].m_CurrentPadStatus = false;
-            g_PadInfo[HEAD_ARRAY_SENSOR_RIGHT].m_CurrentPadStatus = false;
+            pads &= (uint8_t)~HEAD_ARRAY_PADS_LEFT_RIGHT;
         }
 
-        // For all sensors....
-        //      Look for a change in state.
-        //      If so, change the LED appropriately and beep if turning on.
-        for (int sensor_id = 0; sensor_id < (int)HEAD_ARRAY_SENSOR_EOL; sensor_id++)
+        // For all sensors that changed....
+        //      Change the LED appropriately and beep if turning on.
+        changed = pads ^ g_Pads;
+        if (changed != 0)
         {
-            if (g_PadInfo[sensor_id].m_CurrentPadStatus != g_PadInfo[sensor_id].m_PreviousPadStatus)
+            pad_bit = HEAD_ARRAY_PAD_BIT(0);
+            for (int sensor_id = 0; sensor_id < (int)HEAD_ARRAY_SENSOR_EOL; sensor_id++, pad_bit <<= 1)
             {
-                if (g_PadInfo[sensor_id].m_CurrentPadStatus)
-                {
-                    GenOutCtrlBsp_SetActive(g_PadInfo[sensor_id].m_LED_ID);
-                    beeperBeep (BEEPER_PATTERN_PAD_ACTIVE);
-                }
-                else
+                if (changed & pad_bit)
                 {
-                    GenOutCtrlBsp_SetInactive(g_PadInfo[sensor_id].m_LED_ID);
+                    if (pads & pad_bit)
+                    {
+                        GenOutCtrlBsp_SetActive(g_PadLedId[sensor_id]);
+                        beeperBeep (BEEPER_PATTERN_PAD_ACTIVE);
+                    }
+                    else
+                    {
+                        GenOutCtrlBsp_SetInactive(g_PadLedId[sensor_id]);
+                    }
                 }
-                g_PadInfo[sensor_id].m_PreviousPadStatus = g_PadInfo[sensor_id].m_CurrentPadStatus;
-            }            
-        }        
-
-
-
-#ifdef USE_OLD_CODE
-        // Turn on or off the Pad Sensor LED's
-        if (g_PadInfo[HEAD_ARRAY_SENSOR_CENTER].m_CurrentPadStatus != g_PadInfo[HEAD_ARRAY_SENSOR_CENTER].m_PreviousPadStatus)
-        {
-            if (g_PadInfo[HEAD_ARRAY_SENSOR_CENTER].m_CurrentPadStatus)
-            {
-                GenOutCtrlApp_SetStateAll(GEN_OUT_FORWARD_PAD_ACTIVE);
-                beeperBeep (BEEPER_PATTERN_PAD_ACTIVE);
             }
-            else
-            {
-                GenOutCtrlApp_SetStateAll(GEN_OUT_FORWARD_PAD_INACTIVE);
-            }
-            g_PadInfo[HEAD_ARRAY_SENSOR_CENTER].m_PreviousPadStatus = g_PadInfo[HEAD_ARRAY_SENSOR_CENTER].m_CurrentPadStatus;
+            g_Pads = pads;
         }
 
-        if (g_PadInfo[HEAD_ARRAY_SENSOR_LEFT].m_CurrentPadStatus != g_PadInfo[HEAD_ARRAY_SENSOR_LEFT].m_PreviousPadStatus)
+        // Pass the change on now, not at the next run of the main task.
+        if ((changed != 0) || demand_changed)
         {
-            if (g_PadInfo[HEAD_ARRAY_SENSOR_LEFT].m_CurrentPadStatus)
-            {
-                GenOutCtrlApp_SetStateAll(GEN_OUT_LEFT_PAD_ACTIVE);
-                beeperBeep (BEEPER_PATTERN_PAD_ACTIVE);
-            }
-            else
-            {
-                GenOutCtrlApp_SetStateAll(GEN_OUT_LEFT_PAD_INACTIVE);
-            }
-            g_PadInfo[HEAD_ARRAY_SENSOR_LEFT].m_PreviousPadStatus = g_PadInfo[HEAD_ARRAY_SENSOR_LEFT].m_CurrentPadStatus;
+            MainPadsChanged();
         }
+        
+        AppCommonDeadlineComplete(g_HeadArrayTaskDeadlineID);
 
-        if (g_PadInfo[HEAD_ARRAY_SENSOR_RIGHT].m_CurrentPadStatus != g_PadInfo[HEAD_ARRAY_SENSOR_RIGHT].m_PreviousPadStatus)
+        // While a pad is being debounced, sample at the debounce rate.
+        // An edge after the pads were read is still pending at the wait, so the task only
+        // yields and reads it at once.
+        if (DebounceCountingPads() != 0)
         {
-            if (g_PadInfo[HEAD_ARRAY_SENSOR_RIGHT].m_CurrentPadStatus)
-            {
-                GenOutCtrlApp_SetStateAll(GEN_OUT_RIGHT_PAD_ACTIVE);
-                beeperBeep (BEEPER_PATTERN_PAD_ACTIVE);
-            }
-            else
-            {
-                GenOutCtrlApp_SetStateAll(GEN_OUT_RIGHT_PAD_INACTIVE);
-            }
-            g_PadInfo[HEAD_ARRAY_SENSOR_RIGHT].m_PreviousPadStatus = g_PadInfo[HEAD_ARRAY_SENSOR_RIGHT].m_CurrentPadStatus;
+            task_wait(MILLISECONDS_TO_TICKS(PAD_DEBOUNCE_SAMPLE_ms));
         }
-#endif // #ifdef USE_OLD_CODE
-        
-        task_wait(MILLISECONDS_TO_TICKS(HEAD_ARRAY_TASK_DELAY));
+#ifdef HEAD_ARRAY_PROPORTIONAL_PADS
+        else
+        {
+            task_wait(MILLISECONDS_TO_TICKS(PAD_PROP_SAMPLE_ms));
+        }
+#else
+        else
+        {
+            event_wait_timeout_unless(g_PadEdgeEvent, MILLISECONDS_TO_TICKS(HEAD_ARRAY_TASK_DELAY), g_PadEdgePending);
+        }
+#endif
 	}
     task_close();
 }
@@ -245,15 +478,160 @@ static void HeadArrayInputControlTask(void)
 //------------------------------------------------------------------------------
 bool PadsInNeutralState(void)
 {
-    bool active = true;
-	for (int i = 0; i < (int) HEAD_ARRAY_SENSOR_EOL; i++)
-	{
-        if (g_PadInfo[i].m_CurrentPadStatus)    // non-zero is active
-            active = false;                 // Indicate that it's not in neutral
-	}
-    return active;
+    return (g_Pads == 0);
 }
 
+//------------------------------------------------------------------------------
+// Function: DebouncePads
+//
+// Description: Integrating debounce of all pads. The count of a pad that differs from
+//      its debounced state goes up by one each sample, and the count of a pad that agrees
+//      goes down to 0. When the count reaches the assert or the release threshold, the
+//      debounced state of the pad flips and its count restarts.
+//
+// Returns: The debounced pads.
+//
+//------------------------------------------------------------------------------
+static uint8_t DebouncePads(uint8_t raw_pads)
+{
+    uint8_t up = raw_pads ^ g_DebouncedPads;
+    uint8_t down = (uint8_t)~up & DebounceCountingPads();
+    uint8_t carry = up | down;      // Carry for the pads counting up, borrow for those counting down
+    uint8_t done = up;              // Pads whose count equals their threshold
+    uint8_t count;
+    uint8_t threshold;
+
+    for (int k = 0; k < PAD_DEBOUNCE_COUNT_BITS; k++)
+    {
+        count = g_DebounceCount[k];
+        g_DebounceCount[k] = count ^ carry;
+        carry &= count ^ down;
+
+        threshold = (g_DebouncedPads & g_ReleaseCount[k]) | ((uint8_t)~g_DebouncedPads & g_AssertCount[k]);
+        done &= (uint8_t)~(g_DebounceCount[k] ^ threshold);
+    }
+
+    g_DebouncedPads ^= done;
+    for (int k = 0; k < PAD_DEBOUNCE_COUNT_BITS; k++)
+    {
+        g_DebounceCount[k] &= (uint8_t)~done;
+    }
+
+    return g_DebouncedPads;
+}
+
+//------------------------------------------------------------------------------
+// Function: DebounceCountingPads
+//
+// Description: Returns the pads with a debounce count other than 0.
+//
+//------------------------------------------------------------------------------
+static uint8_t DebounceCountingPads(void)
+{
+    uint8_t counting = 0;
+
+    for (int k = 0; k < PAD_DEBOUNCE_COUNT_BITS; k++)
+    {
+        counting |= g_DebounceCount[k];
+    }
+    return counting;
+}
+
+//------------------------------------------------------------------------------
+// Function: DebounceSamples
+//
+// Description: Converts a debounce time to a number of samples, at least 1.
+//
+//------------------------------------------------------------------------------
+static uint8_t DebounceSamples(uint8_t time_ms)
+{
+    uint8_t samples = (uint8_t)((time_ms + (PAD_DEBOUNCE_SAMPLE_ms - 1)) / PAD_DEBOUNCE_SAMPLE_ms);
+
+    if (samples < 1)
+    {
+        samples = 1;
+    }
+    else if (samples > PAD_DEBOUNCE_COUNT_MAX)
+    {
+        samples = PAD_DEBOUNCE_COUNT_MAX;
+    }
+    return samples;
+}
+
+#ifdef HEAD_ARRAY_PROPORTIONAL_PADS
+//------------------------------------------------------------------------------
+// Function: ScalePads
+//
+// Description: Reads the proportional pads from the last scan and scales them to a
+//      drive demand with their calibration, see headArrayPadCalibrationSet(). If the
+//      scan did not finish, its readings are partly updated, so they are not used
+//      and the previous demand is kept.
+//
+// Returns: true if the drive demand of a pad changed. raw_pads is set to the pads
+//      above their minimum threshold.
+//
+//------------------------------------------------------------------------------
+static bool ScalePads(uint8_t *raw_pads)
+{
+    bool changed = false;
+    uint8_t pads = 0;
+    uint8_t percent;
+    uint16_t count;
+    const PadScale_t *scale;
+
+    if (!headArrayBspScanDone())
+    {
+        for (int sensor_id = 0; sensor_id < (int)HEAD_ARRAY_SENSOR_EOL; sensor_id++)
+        {
+            if (g_PadPercent[sensor_id] != 0)
+            {
+                pads |= HEAD_ARRAY_PAD_BIT(sensor_id);
+            }
+        }
+        *raw_pads = pads;
+        return false;
+    }
+
+    for (int sensor_id = 0; sensor_id < (int)HEAD_ARRAY_SENSOR_EOL; sensor_id++)
+    {
+        g_PadRaw[sensor_id] = headArrayBspProportionalState((HeadArraySensor_t)sensor_id);
+
+        scale = &g_PadScale[sensor_id];
+        if (g_PadRaw[sensor_id] <= scale->low)
+        {
+            percent = 0;
+        }
+        else
+        {
+            count = g_PadRaw[sensor_id] - scale->low;
+            if (count >= scale->span)
+            {
+                percent = PAD_PERCENT_MAX;
+            }
+            else
+            {
+                // Rounded to the nearest percent. The gain is rounded too, so limit it.
+                count = (uint16_t)(((uint32_t)count * scale->gain + 0x8000) >> 16);
+                percent = (count > PAD_PERCENT_MAX) ? PAD_PERCENT_MAX : (uint8_t)count;
+            }
+        }
+
+        if (percent != 0)
+        {
+            pads |= HEAD_ARRAY_PAD_BIT(sensor_id);
+        }
+        if (percent != g_PadPercent[sensor_id])
+        {
+            g_PadPercent[sensor_id] = percent;
+            changed = true;
+        }
+    }
+
+    *raw_pads = pads;
+    return changed;
+}
+#endif
+
 #if defined(TEST_BASIC_DAC_CONTROL)
 //------------------------------------------------------------------------------
 // Function: TestBasicDacControl
@@ -33,6 +33,7 @@
 
 void MainTaskInitialise(void);
 bool Does_Main_Allow_Beeping(void);
+void MainPadsChanged(void);
 
 #endif	// MAIN_STATE_H
 
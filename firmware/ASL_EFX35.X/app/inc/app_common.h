@@ -28,6 +28,9 @@
 #define FUNC_FEATURE2_RNET_SLEEP_BIT_MASK               (0x01)
 #define FUNC_FEATURE2_MODE_REVERSE_BIT_MASK             (0x02)
 
+// Max number of tasks watched by the deadline monitor in the system supervisor.
+#define MAX_DEADLINE_MONITORS (4)
+
 #define FUNC_FEATURE_ALL (FUNC_FEATURE_POWER_ON_OFF_BIT_MASK | FUNC_FEATURE_OUT_CTRL_TO_BT_MODULE_BIT_MASK | \
 							FUNC_FEATURE_NEXT_FUNCTION_BIT_MASK | FUNC_FEATURE_NEXT_PROFILE_BIT_MASK | \
                             FUNC_FEATURE_SOUND_ENABLED_BIT_MASK | FUNC_FEATURE_RNET_SEATING_MASK)
@@ -47,6 +50,17 @@ typedef enum
 	FUNC_FEATURE_EOL
 } FunctionalFeature_t;
 
+// Handle returned by AppCommonDeadlineRegister().
+typedef uint8_t DeadlineId_t;
+
+// Deadline monitor results of one task, all times in OS ticks.
+typedef struct
+{
+    uint16_t m_Misses;              // Number of times the deadline was missed
+    uint32_t m_WorstLateness;       // Longest time past the period between completions, latched
+    uint32_t m_WorstGap;            // Longest time between completions, latched
+} DeadlineStats_t;
+
 /* ***********************   Function Prototypes   ************************ */
 
 void AppCommonInit(void);
@@ -61,6 +75,10 @@ void AppCommonDeviceActiveSet(bool is_active);
 bool AppCommonDeviceActiveGet(void);
 void AppCommonForceActiveState (bool is_active);
 
+DeadlineId_t AppCommonDeadlineRegister(uint16_t period_ms, uint16_t deadline_ms, void (*on_miss)(void));
+void AppCommonDeadlineComplete(DeadlineId_t id);
+void AppCommonDeadlineStatsGet(DeadlineId_t id, DeadlineStats_t *stats);
+
 //void AppCommonCalibrationActiveSet(bool put_into_calibration);
 //bool AppCommonCalibrationActiveGet(void);
 
@@ -53,7 +53,6 @@ typedef struct
 } BeepMsg_t;
 
 // Mailbox definitions for sending info to Beep Task.
-extern uint8_t g_BeeperTaskID;
 extern BeepPattern_t g_NewBeepPattern;
 
 /* ***********************   Function Prototypes   ************************ */
@@ -0,0 +1,66 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Filename: drive_ramp.h
+//
+// Description: Ramps the drive demand sent to the eFix, limiting the acceleration
+//      and the jerk.
+//
+// Author(s): G. Chopcinski (Kg Solutions, LLC)
+//
+// Modified for ASL on Date:
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef DRIVE_RAMP_H
+#define DRIVE_RAMP_H
+
+/* ***************************    Includes     **************************** */
+
+// from stdlib
+#include <stdint.h>
+#include <stdbool.h>
+
+/* ******************************   Macros   ****************************** */
+
+// driveRampUpdate() must be called once per this period while the ramp is moving.
+#define DRIVE_RAMP_PERIOD_ms            (20)
+
+// Default profiles. Acceleration and deceleration are in percent of full demand per
+// second, jerk in percent per second per second. 0 means no limit. Stored in EEPROM
+// with ASL110. Deceleration is quicker than acceleration so the chair stops promptly.
+#define DRIVE_RAMP_FWD_ACCEL_DEFAULT    (60)
+#define DRIVE_RAMP_FWD_DECEL_DEFAULT    (150)
+#define DRIVE_RAMP_FWD_JERK_DEFAULT     (200)
+#define DRIVE_RAMP_REV_ACCEL_DEFAULT    (40)
+#define DRIVE_RAMP_REV_DECEL_DEFAULT    (150)
+#define DRIVE_RAMP_REV_JERK_DEFAULT     (150)
+#define DRIVE_RAMP_TURN_ACCEL_DEFAULT   (100)
+#define DRIVE_RAMP_TURN_DECEL_DEFAULT   (200)
+#define DRIVE_RAMP_TURN_JERK_DEFAULT    (250)
+
+/* ******************************   Types   ******************************* */
+
+typedef enum
+{
+    DRIVE_RAMP_PROFILE_FORWARD,
+    DRIVE_RAMP_PROFILE_REVERSE,
+    DRIVE_RAMP_PROFILE_TURN,
+
+	// Nothing else may be defined past this point!
+    DRIVE_RAMP_PROFILE_EOL
+} DriveRampProfile_t;
+
+/* ***********************   Function Prototypes   ************************ */
+
+void driveRampInit(void);
+void driveRampProfileSet(DriveRampProfile_t profile, uint8_t accel, uint8_t decel, uint8_t jerk);
+void driveRampUpdate(int16_t speed_target, int16_t direction_target);
+void driveRampStop(void);
+bool driveRampSettled(void);
+int16_t driveRampSpeedGet(void);
+int16_t driveRampDirectionGet(void);
+
+#endif // DRIVE_RAMP_H
+
+// end of file.
+//-------------------------------------------------------------------------
@@ -33,10 +33,14 @@
 #define	EFIX_COMMUNICATION_H
 
 #include <xc.h> // include processor files - each processor file is guarded.  
+#include <stdint.h>
+#include <stdbool.h>
 
 void eFix_Communincation_Initialize(void);
 void RS232_TransmitChar (unsigned char item);
 void SetSpeedAndDirection (int speed, int direction);
+bool eFixIsReady (void);
+uint8_t eFixErrorCodeGet (void);
 
 
 #endif	/* EFIX_COMMUNICATION_H */
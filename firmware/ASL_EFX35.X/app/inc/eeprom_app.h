@@ -35,7 +35,9 @@
 // 4 = Original plus some stuff, supported by 1.6.x
 // 5 = Changed to support Minimum Drive Speed for all 3 pads.
 // 6 = [9/18/20] Added RNet Sleep feature and Mode Switch Schema feature.
-#define EEPROM_DATA_STRUCTURE_VERSION				((uint8_t)0x06)
+// 7 = Added pad debounce assert and release times.
+// 8 = Added forward, reverse and turn drive ramp profiles.
+#define EEPROM_DATA_STRUCTURE_VERSION				((uint8_t)0x08)
 
 /* ******************************   Types   ******************************* */
 #ifdef ASL110
@@ -83,6 +85,19 @@ typedef enum
     EEPROM_STORED_ITEM_MM_RIGHT_PAD_MINIMUM_DRIVE_OFFSET,
             
     EEPROM_STORED_ITEM_ENABLED_FEATURES_2,
+
+    EEPROM_STORED_ITEM_PAD_ASSERT_TIME,
+    EEPROM_STORED_ITEM_PAD_RELEASE_TIME,
+
+    EEPROM_STORED_ITEM_RAMP_FWD_ACCEL,
+    EEPROM_STORED_ITEM_RAMP_FWD_DECEL,
+    EEPROM_STORED_ITEM_RAMP_FWD_JERK,
+    EEPROM_STORED_ITEM_RAMP_REV_ACCEL,
+    EEPROM_STORED_ITEM_RAMP_REV_DECEL,
+    EEPROM_STORED_ITEM_RAMP_REV_JERK,
+    EEPROM_STORED_ITEM_RAMP_TURN_ACCEL,
+    EEPROM_STORED_ITEM_RAMP_TURN_DECEL,
+    EEPROM_STORED_ITEM_RAMP_TURN_JERK,
 	// Nothing else may be defined past this point!
 	EEPROM_STORED_ITEM_EOL
 } EepromItemId_t;
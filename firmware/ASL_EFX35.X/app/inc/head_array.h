@@ -22,14 +22,35 @@
 // from local
 #include "head_array_common.h"
 
+/* ******************************   Macros   ****************************** */
+
+// Time a pad must be seen active before it is taken as active, and inactive before it is
+// taken as inactive, in milliseconds. Stored in EEPROM with ASL110. The release time is
+// short so the chair stops quickly.
+#define HEAD_ARRAY_PAD_ASSERT_TIME_DEFAULT_ms   (10)
+#define HEAD_ARRAY_PAD_RELEASE_TIME_DEFAULT_ms  (4)
+
+// Default thresholds of the proportional pads, in percent of the calibrated range. Below the
+// minimum a pad is inactive, at the maximum it gives full drive demand.
+#define HEAD_ARRAY_PAD_MIN_THRESH_PERC_DEFAULT  (2)
+#define HEAD_ARRAY_PAD_MAX_THRESH_PERC_DEFAULT  (30)
+
 /* ******************************   Types   ******************************* */
 
 /* ***********************   Function Prototypes   ************************ */
 
 void headArrayinit(void);
 bool headArrayDigitalInputValue(HeadArraySensor_t sensor);
+uint8_t headArrayDigitalInputs(void);
+void headArrayDebounceTimesSet(uint8_t assert_ms, uint8_t release_ms);
+uint8_t headArrayProportionalInputValue(HeadArraySensor_t sensor);
+uint16_t headArrayProportionalInputValueRaw(HeadArraySensor_t sensor);
+void headArrayPadCalibrationSet(HeadArraySensor_t sensor, uint16_t min_adc, uint16_t max_adc, uint16_t min_thresh_perc, uint16_t max_thresh_perc);
 bool headArrayPadIsConnected(HeadArraySensor_t sensor);
 bool PadsInNeutralState (void);
+void headArrayPadEdgeIsr(void);
+uint32_t headArrayPadEdgeLatencyMaxGet(void);
+void headArrayPadScanIsr(void);
 
 #endif // HEAD_ARRAY_H
 
@@ -16,24 +16,83 @@
 /* ******************************   Macros   ****************************** */
 
 // 0 is the highest priority, 255 is lowest and also the highest allowable value
-// NOTE: They must be unique
+// NOTE: They must be unique. This is checked at build time for the tasks in OS_TASK_TABLE.
 #define USER_BTN_MGMT_TASK_PRIO		(3)
 #define EFIX_COMM_TASK_PRIO 		(1)
 #define HEAD_ARR_MGMT_TASK_PRIO		(2)
 #define GEN_OUT_CTRL_MGMT_TASK_PRIO	(4)
 #define BEEPER_MGMT_TASK_PRIO		(5)
-#define HA_HHP_IF_MGMT_TASK_PRIO	(2)
+#define HA_HHP_IF_MGMT_TASK_PRIO	(9)
 #define SYSTEM_SUPERVISOR_TASK_PRIO	(0)
 #define MAIN_TASK_PRIO              (6)
-#define NEW_TASK7                   (7)
+#define EFIX_RECV_TASK_PRIO         (7)
+#define TRACE_APP_TASK_PRIO         (8)     // Only created with OS_TRACE
 
 // I'm including the task delays to ensure proper sequencing.
 #define MAIN_TASK_DELAY (37)        // Number of milliseconds for the main task.
 #define BEEPER_TASK_DELAY (10)      // Slighly faster than the Main Task.
 // I believe that msg's must be pulled out of the queue. It behaves if the
 // msg queue gets full even if use the "_async" calls.
+// The head array task is woken by pad edge interrupts. This is how often it also reads
+// the pads, for the right pad on the PIC18F4550 that has no edge interrupt.
+#ifdef _18F46K40
+#define HEAD_ARRAY_TASK_DELAY (100)
+#else
 #define HEAD_ARRAY_TASK_DELAY (20)
+#endif
 #define USER_BUTTON_TASK_DELAY (50)
+#define TRACE_APP_TASK_DELAY (10)
+// The eFix 35 system is expecting messages at least every 100 milliseconds,
+// otherwise, a hard errror occurs.
+// A new command is sent at once and a moving ramp once per ramp period. A steady
+// command is only repeated at this keep-alive period, well inside the 100 ms.
+//#define EFIX_COMM_TASK_DELAY (15)
+#define EFIX_COMM_TASK_DELAY (70)
+// The eFix receive task is woken by the received characters, it has no period.
+#define SYS_SUPERVISOR_TASK_EXECUTION_RATE_ms (20)
+
+// Longest time allowed between two completions of a periodic task, in milliseconds.
+// Checked by the deadline monitor in the system supervisor, see app_common.c.
+#define MAIN_TASK_DEADLINE (MAIN_TASK_DELAY * 2)
+#define BEEPER_TASK_DEADLINE (BEEPER_TASK_DELAY * 4)
+#define HEAD_ARRAY_TASK_DEADLINE (HEAD_ARRAY_TASK_DELAY * 2)
+// The eFix watchdog time. If the task has not sent a message for this long, the
+// system supervisor drives the command to neutral.
+#define EFIX_COMM_TASK_DEADLINE (100)
+
+// Task table. One line for each task in the system, in priority order:
+//
+//  X(name, entry, prio, period_ms, queue_size, msg_size, events, semaphores)
+//
+//      name        The task id is name##_TASK_ID, for example MAIN_TASK_ID.
+//      entry       Task function, void entry(void). The prototype is declared by cocoos.h.
+//      prio        Task priority from above.
+//      period_ms   Release period of a periodic task, 0 if it is not periodic. Must fit in
+//                  a task timeout, see OS_TASK_TIME_BITS in os_defines.h.
+//      queue_size  Number of messages in the task message queue, 0 for no queue.
+//      msg_size    Size of a message in the queue. Must be known in os_task.c.
+//      events      Number of events created for the task, including those signaled from ISRs.
+//      semaphores  Number of semaphores created by the module of the task.
+//
+// cocoOS counts N_TASKS, N_QUEUES, N_EVENTS and N_SEMAPHORES from this table and builds
+// the task control blocks at compile time, see OS_STATIC_TASKS in os_defines.h. The general
+// output control and HHP interface tasks are not listed as those modules are not built.
+#ifdef OS_TRACE
+#define TRACE_APP_TASK_ENTRY(X) \
+    X(TRACE_APP, TraceDrainTask, TRACE_APP_TASK_PRIO, TRACE_APP_TASK_DELAY, 0, 0, 0, 0)
+#else
+#define TRACE_APP_TASK_ENTRY(X)
+#endif
+
+#define OS_TASK_TABLE(X) \
+    X(SYSTEM_SUPERVISOR, SystemSupervisorTask, SYSTEM_SUPERVISOR_TASK_PRIO, SYS_SUPERVISOR_TASK_EXECUTION_RATE_ms, 0, 0, 0, 0) \
+    X(EFIX_COMM, eFix_Communication_Task, EFIX_COMM_TASK_PRIO, EFIX_COMM_TASK_DELAY, 0, 0, 2, 0) \
+    X(HEAD_ARRAY, HeadArrayInputControlTask, HEAD_ARR_MGMT_TASK_PRIO, HEAD_ARRAY_TASK_DELAY, 0, 0, 1, 0) \
+    X(USER_BUTTON, UserButtonMonitorTask, USER_BTN_MGMT_TASK_PRIO, USER_BUTTON_TASK_DELAY, 0, 0, 0, 1) \
+    X(BEEPER, BeepPatternTask, BEEPER_MGMT_TASK_PRIO, BEEPER_TASK_DELAY, 0, 0, 0, 1) \
+    X(MAIN, MainTask, MAIN_TASK_PRIO, MAIN_TASK_DELAY, 0, 0, 0, 0) \
+    X(EFIX_RECV, eFix_Receive_Task, EFIX_RECV_TASK_PRIO, 0, 0, 0, 1, 0) \
+    TRACE_APP_TASK_ENTRY(X)
 
 #endif // End of RTOS_TASK_PRIORITIES_H_
 
@@ -23,8 +23,12 @@
 #include "cocoos.h"
 
 // from project
+#include "bsp.h"
 #include "test_gpio.h"
 #include "stopwatch.h"
+#include "head_array_bsp.h"
+#include "head_array.h"
+#include "RS232.h"
 
 static uint32_t num_os_ticks_to_process = 0;
 static bool can_process_os_ticks = true;
@@ -69,14 +73,18 @@ __interrupt(high_priority) void highPrioIsr(void)
 //-------------------------------
 __interrupt(low_priority) void lowPrioIsr(void)
 {
+	uint8_t num_ticks;
+
 	// ISRs here are assigned to the lower priority vector in bsp.c
 #ifdef _18F46K40
     if (PIR4bits.TMR2IF)
     {
         PIR4bits.TMR2IF = 0;
         
-		stopwatchTick();
-		num_os_ticks_to_process++;
+		// More than one tick has passed if the CPU was idling with a longer tick period.
+		num_ticks = bspSysTickPeriodsElapsed();
+		stopwatchTickN(num_ticks);
+		num_os_ticks_to_process += num_ticks;
 		
 		// This tick takes ~240 us. Which, when doing certain time critical operations may not be acceptable.
 		// The system must be able to handle missing any number of ticks that are missed when os_tick() is disabled.
@@ -91,8 +99,10 @@ __interrupt(low_priority) void lowPrioIsr(void)
     if (PIR1bits.TMR2IF)
     {
         PIR1bits.TMR2IF = 0;
-		stopwatchTick();
-		num_os_ticks_to_process++;
+		// More than one tick has passed if the CPU was idling with a longer tick period.
+		num_ticks = bspSysTickPeriodsElapsed();
+		stopwatchTickN(num_ticks);
+		num_os_ticks_to_process += num_ticks;
 		
 		// This tick takes ~240 us. Which, when doing certain time critical operations may not be acceptable.
 		// The system must be able to handle missing any number of ticks that are missed when os_tick() is disabled.
@@ -103,6 +113,22 @@ __interrupt(low_priority) void lowPrioIsr(void)
 		}
     }
 #endif
+
+    // Head array pad edges
+    if (headArrayBspEdgeIsr())
+    {
+        headArrayPadEdgeIsr();
+    }
+
+    // Head array proportional pad conversions
+    if (headArrayBspAdcIsr())
+    {
+        headArrayPadScanIsr();
+    }
+
+    // eFix messages
+    RS232_ReceiveIsr();
+    RS232_TransmitIsr();
 }
 
 // end of file.
@@ -82,6 +82,7 @@ int main(void)
     eFix_Communincation_Initialize();
     MainTaskInitialise();
     
+	// NOTE: Not with HEAD_ARRAY_PROPORTIONAL_PADS on the PIC18F4550, see haHhpBsp_Init().
 //	haHhpApp_Init();
 
 	// This must come after beeperInit() otherwise the pattern request will be ignored by the beeper module.
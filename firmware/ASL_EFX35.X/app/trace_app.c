@@ -0,0 +1,138 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Filename: trace_app.c
+//
+// Description: Drains the cocoOS kernel trace (OS_TRACE in os_defines.h) to the
+//      RS232 port, for support/tools/trace_export/trace_export.py.
+//
+//      The RS232 port is the eFix link, so only build with OS_TRACE on the bench,
+//      with the PC tapped onto TX. The eFix task and this task both send whole
+//      frames before they yield, so the frames never interleave.
+//
+//      Frame: SOT, record count, lost record count, records, checksum.
+//      Each record is type, id, time low byte, time high byte. The checksum makes
+//      the byte sum of the frame 0.
+//
+// Author(s): 
+//
+// Modified for ASL on Date: 
+//
+//////////////////////////////////////////////////////////////////////////////
+
+/* **************************   Header Files   *************************** */
+
+// NOTE: This must ALWAYS be the first include in a file.
+#include "device.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// from RTOS
+#include "cocoos.h"
+#include "rtos_task_priorities.h"
+
+// from project
+#include "common.h"
+#include "RS232.h"
+
+#ifdef OS_TRACE
+
+/* ******************************   Macros   ****************************** */
+
+#define TRACE_FRAME_SOT (0xa5)
+
+// Records per frame. 8 records are 37 bytes, about 3.2 ms at 115.2K, which is
+// how long the other tasks are held off.
+#define TRACE_RECORDS_PER_FRAME (8)
+
+/* ***********************   Function Prototypes   ************************ */
+
+static void SendTraceByte(uint8_t item);
+
+/* *******************   Public Function Definitions   ******************** */
+
+//-------------------------------
+// Function: TraceDrainTask
+//
+// Description: Sends a frame of trace records every TRACE_APP_TASK_DELAY milliseconds.
+//      Frames without records are only sent to report lost records. The task is in
+//      OS_TASK_TABLE when OS_TRACE is defined, and starts after the RS232 port is
+//      initialized by main().
+//
+//-------------------------------
+void TraceDrainTask(void)
+{
+    static TraceRecord_t records[TRACE_RECORDS_PER_FRAME];
+    static uint8_t num_records;
+    static uint8_t num_lost;
+    static uint8_t checksum;
+    static uint8_t i;
+
+    task_open();
+
+    while (1)
+    {
+        task_wait(MILLISECONDS_TO_TICKS(TRACE_APP_TASK_DELAY));
+
+        for (num_records = 0; num_records < TRACE_RECORDS_PER_FRAME; ++num_records)
+        {
+            if (trace_read(&records[num_records]) == 0)
+            {
+                break;
+            }
+        }
+
+        num_lost = trace_lost_get();
+
+        if ((num_records == 0) && (num_lost == 0))
+        {
+            continue;
+        }
+
+        checksum = TRACE_FRAME_SOT + num_records + num_lost;
+        SendTraceByte(TRACE_FRAME_SOT);
+        SendTraceByte(num_records);
+        SendTraceByte(num_lost);
+
+        for (i = 0; i < num_records; ++i)
+        {
+            checksum += records[i].type + records[i].id + (uint8_t)records[i].time + (uint8_t)(records[i].time >> 8);
+            SendTraceByte(records[i].type);
+            SendTraceByte(records[i].id);
+            SendTraceByte((uint8_t)records[i].time);
+            SendTraceByte((uint8_t)(records[i].time >> 8));
+        }
+
+        SendTraceByte((uint8_t)(0 - checksum));
+
+        // Let the last character out before another task can use the port.
+        while (RS232_TransmitReady() == false)
+        {
+            ;
+        }
+    }
+
+    task_close();
+}
+
+/* ********************   Private Function Definitions   ****************** */
+
+//-------------------------------
+// Function: SendTraceByte
+//
+// Description: Sends one character, waiting for the transmit buffer.
+//
+//-------------------------------
+static void SendTraceByte(uint8_t item)
+{
+    while (RS232_TransmitReady() == false)
+    {
+        ;
+    }
+    RS232_TransmitChar(item);
+}
+
+#endif // #ifdef OS_TRACE
+
+// end of file.
+//-------------------------------------------------------------------------
@@ -87,7 +87,6 @@ static volatile uint16_t time_for_func_to_trigger_ms[] =
 
 /* ***********************   Function Prototypes   ************************ */
 
-static void UserButtonMonitorTask (void);
 static void ResetButtonMonitoring(void);
 static void CarryOutShortPressAction(void);
 static void CarryOutLongPressAction(void);
@@ -122,7 +121,6 @@ void userButtonInit(void)
 	time_for_func_to_trigger_ms[(int)USER_BTN_PRESS_SHORT] = 50; // 100;
 	time_for_func_to_trigger_ms[(int)USER_BTN_PRESS_LONG] = 1000;
 
-    (void)task_create(UserButtonMonitorTask , NULL, USER_BTN_MGMT_TASK_PRIO, NULL, 0, 0);
 }
 
 /* ********************   Private Function Definitions   ****************** */
@@ -155,7 +153,7 @@ uint8_t GetSwitchStatus(void)
 //
 //-------------------------------
 
-static void UserButtonMonitorTask (void)
+void UserButtonMonitorTask (void)
 {
     Evt_t event_to_send_beeper_task;
     int currentFeature;
@@ -158,5 +158,19 @@ bool bluetoothSimpleIfBspPadMirrorStateGet(HeadArraySensor_t sensor_id)
     return false;   // TODO: Replace with real code.
 }
 
+//-------------------------------
+// Function: bluetoothSimpleIfBspPadMirrorSet
+//
+// Description: Sets all mirrored head array sensor outputs to the bluetooth module from a pad bitmask,
+//		see HEAD_ARRAY_PAD_BIT(). The back pad is not mirrored.
+//
+//-------------------------------
+void bluetoothSimpleIfBspPadMirrorSet(uint8_t pads)
+{
+	BT_LEFT_PAD_SET(pads & HEAD_ARRAY_PAD_BIT(HEAD_ARRAY_SENSOR_LEFT));
+	BT_RIGHT_PAD_SET(pads & HEAD_ARRAY_PAD_BIT(HEAD_ARRAY_SENSOR_RIGHT));
+	BT_CTR_PAD_SET(pads & HEAD_ARRAY_PAD_BIT(HEAD_ARRAY_SENSOR_CENTER));
+}
+
 // end of file.
 //-------------------------------------------------------------------------
@@ -24,11 +24,19 @@
 #define ISR_LOW_PRIO_SET_VAL 	0
 #define ISR_HIGH_PRIO_SET_VAL 	1
 
+// The timer 2 postscaler divides by 1 to 16, so one tick interrupt can cover at most 16 ticks.
+#define SYS_TICK_MAX_IDLE_TICKS	16
+
 /* ***********************   Function Prototypes   ************************ */
 
 static void InterruptsInit(void);
 static void SysTickTimerInit(void);
 
+/* ***********************   File Scope Variables   *********************** */
+
+// Number of 1 ms ticks covered by one timer 2 interrupt. Only more than 1 while idling.
+static uint8_t sys_tick_periods = 1;
+
 /* *******************   Public Function Definitions   ******************** */
 
 //-------------------------------
@@ -128,6 +136,74 @@ void bspDelayMs(uint16_t delay)
 	}
 }
 
+//-------------------------------
+// Function: bspSysTickIdle
+//
+// Description: Idles the CPU for up to num_ticks system ticks. The timer 2 postscaler is set to the number
+//		of ticks, so the tick interrupt fires once at the end instead of every millisecond. Must be called
+//		with interrupts disabled. Any enabled interrupt wakes the CPU, and it is serviced once interrupts
+//		are enabled again.
+//
+// NOTE: If the CPU is woken early, the long period keeps running so no time is lost, but ticks are then
+//		credited up to SYS_TICK_MAX_IDLE_TICKS - 1 ms late. The postscaler count can not be read to credit
+//		the ticks that passed at the early wake, which is why OS_TICKLESS_IDLE is off by default.
+//
+//-------------------------------
+void bspSysTickIdle(uint32_t num_ticks)
+{
+#ifdef _18F46K40
+	if (PIR4bits.TMR2IF)
+#else
+	if (PIR1bits.TMR2IF)
+#endif
+	{
+		return; // A tick is already pending, it would otherwise be credited as a long period.
+	}
+
+	if (num_ticks > SYS_TICK_MAX_IDLE_TICKS)
+	{
+		num_ticks = SYS_TICK_MAX_IDLE_TICKS;
+	}
+
+	// Writing the postscaler clears its count, so it is only changed when the 1 ms period is running.
+	// TMR2 keeps counting, so the part of the current tick that has passed is not lost.
+	if ((sys_tick_periods == 1) && (num_ticks > 1))
+	{
+		sys_tick_periods = (uint8_t)num_ticks;
+#ifdef _18F46K40
+		T2CONbits.OUTPS = sys_tick_periods - 1;
+#else
+		T2CONbits.TOUTPS = sys_tick_periods - 1;
+#endif
+	}
+
+	SLEEP(); // Idle mode, IDLEN is set by SysTickTimerInit()
+}
+
+//-------------------------------
+// Function: bspSysTickPeriodsElapsed
+//
+// Description: Returns the number of 1 ms ticks that passed since the last tick interrupt, and goes back to
+//		a 1 ms tick period. Must be called from the timer 2 ISR.
+//
+//-------------------------------
+uint8_t bspSysTickPeriodsElapsed(void)
+{
+	uint8_t periods = sys_tick_periods;
+
+	if (periods > 1)
+	{
+		sys_tick_periods = 1;
+#ifdef _18F46K40
+		T2CONbits.OUTPS = 0; // /1 postscaler
+#else
+		T2CONbits.TOUTPS = 0; // /1 postscaler
+#endif
+	}
+
+	return periods;
+}
+
 /* ********************   Private Function Definitions   ****************** */
 
 //-------------------------------
@@ -148,6 +224,7 @@ static void SysTickTimerInit(void)
     IPR4bits.TMR2IP = ISR_LOW_PRIO_SET_VAL;
     PIE4bits.TMR2IE = 1; // Enable timer interrupt
     T2CONbits.TMR2ON = 1; // Enable the timer.
+    CPUDOZEbits.IDLEN = 1; // SLEEP idles the CPU only, timer 2 keeps running to wake it
 #else
     T2CONbits.T2CKPS = 3; // /16 prescaler
     T2CONbits.TOUTPS = 0; // /1 postscaler
@@ -155,6 +232,7 @@ static void SysTickTimerInit(void)
     IPR1bits.TMR2IP = ISR_LOW_PRIO_SET_VAL;
     PIE1bits.TMR2IE = 1; // Enable timer interrupt
     T2CONbits.TMR2ON = 1; // Enable the timer.
+    OSCCONbits.IDLEN = 1; // SLEEP idles the CPU only, timer 2 keeps running to wake it
 #endif
 }
 
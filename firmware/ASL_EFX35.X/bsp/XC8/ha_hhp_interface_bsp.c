@@ -155,6 +155,9 @@ static inline bool WaitForMstRtsPinToGoInactive(uint8_t timeout_cycles);
 //
 // Description: Initializes this module
 //
+// NOTE: Not usable with HEAD_ARRAY_PROPORTIONAL_PADS on the PIC18F4550. The pad ADC setup
+// NOTE: makes RE0 and RE2 analog, and the clock and data inputs then always read low.
+//
 //-------------------------------
 void haHhpBsp_Init(void)
 {
@@ -22,6 +22,7 @@
 #include "user_assert.h"
 
 // from project
+#include "config.h"
 #include "bsp.h"
 #include "common.h"
 #include "head_array_common.h"
@@ -31,8 +32,74 @@
 
 /* ******************************   Macros   ****************************** */
 
-#define DIG_PAD_ACTIVE_STATE		GPIO_LOW
-#define DIG_PAD_INACTIVE_STATE		GPIO_HIGH
+// The pads are on RB1 - RB4, shifted down to bit 0 - 3 to index g_PortToPads[].
+#define PAD_PORT_SHIFT          (1)
+#define PAD_PORT_MASK           (0x0F)
+
+#define PAD_PORT_LEFT           (0x01)  // RB1, D1 Pad
+#define PAD_PORT_BACK           (0x02)  // RB2, D2 Pad
+#define PAD_PORT_RIGHT          (0x04)  // RB3, D3 Pad
+#define PAD_PORT_CENTER         (0x08)  // RB4, D4 Pad
+
+#define PAD_MAP(port)           ((((port) & PAD_PORT_LEFT) ? HEAD_ARRAY_PAD_BIT(HEAD_ARRAY_SENSOR_LEFT) : 0) | \
+                                 (((port) & PAD_PORT_RIGHT) ? HEAD_ARRAY_PAD_BIT(HEAD_ARRAY_SENSOR_RIGHT) : 0) | \
+                                 (((port) & PAD_PORT_CENTER) ? HEAD_ARRAY_PAD_BIT(HEAD_ARRAY_SENSOR_CENTER) : 0) | \
+                                 (((port) & PAD_PORT_BACK) ? HEAD_ARRAY_PAD_BIT(HEAD_ARRAY_SENSOR_BACK) : 0))
+
+#define ISR_LOW_PRIO_SET_VAL 	0
+
+#define PAD_PORTB_MASK          (0x1E)  // RB1 - RB4
+
+// Conversions averaged for each proportional pad reading, 2^PAD_ADC_OVERSAMPLE_SHIFT.
+#define PAD_ADC_OVERSAMPLE_SHIFT    (4)
+#define PAD_ADC_OVERSAMPLE          (1 << PAD_ADC_OVERSAMPLE_SHIFT)
+
+#ifdef _18F46K40
+#define PAD_ADC_LEFT            (0x09)  // ANB1
+#define PAD_ADC_BACK            (0x0A)  // ANB2
+#define PAD_ADC_RIGHT           (0x0B)  // ANB3
+#define PAD_ADC_CENTER          (0x0C)  // ANB4
+#define PAD_ADC_ACQ_TAD         (4)     // Acquisition time after a channel change, in TADs
+#define PAD_ADC_START(channel)  INLINE_EXPR(ADPCH = (channel); ADCON0bits.ADGO = 1)
+#else
+#define PAD_ADC_LEFT            (10)    // AN10, RB1
+#define PAD_ADC_BACK            (8)     // AN8, RB2
+#define PAD_ADC_RIGHT           (9)     // AN9, RB3
+#define PAD_ADC_CENTER          (11)    // AN11, RB4
+#define PAD_ADC_PCFG            (0x03)  // AN0 - AN11 analog, AN12 (RB0) digital
+#define PAD_ADC_START(channel)  INLINE_EXPR(ADCON0bits.CHS = (channel); ADCON0bits.GO = 1)
+#endif
+
+/* ***********************   File Scope Variables   *********************** */
+
+// Active pin bits of the port to active pads.
+static const uint8_t g_PortToPads[PAD_PORT_MASK + 1] =
+{
+    PAD_MAP(0),  PAD_MAP(1),  PAD_MAP(2),  PAD_MAP(3),
+    PAD_MAP(4),  PAD_MAP(5),  PAD_MAP(6),  PAD_MAP(7),
+    PAD_MAP(8),  PAD_MAP(9),  PAD_MAP(10), PAD_MAP(11),
+    PAD_MAP(12), PAD_MAP(13), PAD_MAP(14), PAD_MAP(15)
+};
+
+#ifdef HEAD_ARRAY_PROPORTIONAL_PADS
+// ADC channel of each pad, in HeadArraySensor_t order.
+static const uint8_t g_PadAdcChannel[HEAD_ARRAY_SENSOR_EOL] =
+{
+    PAD_ADC_LEFT,
+    PAD_ADC_RIGHT,
+    PAD_ADC_CENTER,
+    PAD_ADC_BACK
+};
+
+static volatile uint16_t g_PadAdc[HEAD_ARRAY_SENSOR_EOL];      // Last reading of each pad
+static volatile uint8_t g_ScanPad = HEAD_ARRAY_SENSOR_EOL;      // Pad being converted, HEAD_ARRAY_SENSOR_EOL when idle
+
+#ifndef _18F46K40
+// Software oversampling of the pad being converted
+static uint16_t g_AdcSum;
+static uint8_t g_AdcSamples;
+#endif
+#endif
 
 /* *******************   Public Function Definitions   ******************** */
 
@@ -48,36 +115,237 @@ void headArrayBspInit(void)
     TRISBbits.TRISB2 = GPIO_BIT_INPUT;      // D2 Pad
     TRISBbits.TRISB3 = GPIO_BIT_INPUT;      // D3 Pad
     TRISBbits.TRISB4 = GPIO_BIT_INPUT;      // D4 Pad
+
+#ifdef HEAD_ARRAY_PROPORTIONAL_PADS
+    // The pads are converted by the low priority ISR, see headArrayBspAdcIsr().
+#ifdef _18F46K40
+    ANSELB |= PAD_PORTB_MASK;
+    ADREF = 0;                              // VDD and VSS references
+    ADACQ = PAD_ADC_ACQ_TAD;
+    ADCON2bits.ADMD = 0b011;                // Burst average, ADFLTR = ADACC >> ADCRS
+    ADCON2bits.ADCRS = PAD_ADC_OVERSAMPLE_SHIFT;
+    ADRPT = PAD_ADC_OVERSAMPLE;
+    ADCON3bits.ADTMD = 0b111;               // ADTIF at the end of every burst
+    ADCON0bits.ADFM = 1;                    // Right justified
+    ADCON0bits.ADCS = 1;                    // FRC clock
+    ADCON0bits.ADON = 1;
+    IPR1bits.ADTIP = ISR_LOW_PRIO_SET_VAL;
+    PIR1bits.ADTIF = 0;
+    PIE1bits.ADTIE = 1;
+#else
+    // The analog pins can only be selected from AN0 up, so RA0 - RA3, RA5 and RE0 - RE2
+    // are analog too. Their digital inputs read 0, the outputs are not affected.
+    // NOTE: The HHP interface reads RE0 and RE2 as digital inputs, see ha_hhp_interface_bsp.c.
+    // NOTE: It can not be used with proportional pads on the PIC18F4550.
+    ADCON1bits.VCFG = 0;                    // VDD and VSS references
+    ADCON1bits.PCFG = PAD_ADC_PCFG;
+    ADCON2bits.ADFM = 1;                    // Right justified
+    ADCON2bits.ACQT = 0b010;                // 4 TAD acquisition
+    ADCON2bits.ADCS = 0b101;                // FOSC/16, 1.6 us TAD at 10 MHz
+    ADCON0bits.ADON = 1;
+    IPR1bits.ADIP = ISR_LOW_PRIO_SET_VAL;
+    PIR1bits.ADIF = 0;
+    PIE1bits.ADIE = 1;
+#endif
+#else
+    // Pad edges are handled by the low priority ISR, see headArrayBspEdgeIsr().
+#ifdef _18F46K40
+    IOCBP |= PAD_PORTB_MASK;                // Both edges of all pads
+    IOCBN |= PAD_PORTB_MASK;
+    IOCBF &= ~PAD_PORTB_MASK;
+    IPR0bits.IOCIP = ISR_LOW_PRIO_SET_VAL;
+    PIE0bits.IOCIE = 1;
+#else
+    // INT1 and INT2 only trigger on one edge, the ISR flips it after every edge.
+    INTCON2bits.INTEDG1 = (PORTBbits.RB1 == GPIO_LOW);
+    INTCON2bits.INTEDG2 = (PORTBbits.RB2 == GPIO_LOW);
+    INTCON3bits.INT1IP = ISR_LOW_PRIO_SET_VAL;
+    INTCON3bits.INT2IP = ISR_LOW_PRIO_SET_VAL;
+    INTCON3bits.INT1IF = 0;
+    INTCON3bits.INT2IF = 0;
+    INTCON3bits.INT1IE = 1;                 // D1 Pad, RB1
+    INTCON3bits.INT2IE = 1;                 // D2 Pad, RB2
+
+    // The port change interrupt covers RB4 - RB7. Reading PORTB ends the mismatch.
+    (void)PORTB;
+    INTCON2bits.RBIP = ISR_LOW_PRIO_SET_VAL;
+    INTCONbits.RBIF = 0;
+    INTCONbits.RBIE = 1;                    // D4 Pad, RB4
+    // RB3, the D3 Pad, has no interrupt and is polled.
+#endif
+#endif
+}
+
+//-------------------------------
+// Function: headArrayBspEdgeIsr
+//
+// Description: Clears the pad edge interrupts. Must be called from the low priority ISR.
+//
+// Returns: true if a pad changed.
+//
+//-------------------------------
+bool headArrayBspEdgeIsr(void)
+{
+    bool edge = false;
+#ifdef HEAD_ARRAY_PROPORTIONAL_PADS
+    // Not used, the pins are analog.
+#elif defined(_18F46K40)
+    uint8_t flags = IOCBF & PAD_PORTB_MASK;
+
+    if (flags != 0)
+    {
+        IOCBF ^= flags;                     // Only clears the flags that were read
+        edge = true;
+    }
+#else
+    if (INTCON3bits.INT1IF)
+    {
+        INTCON3bits.INT1IF = 0;
+        INTCON2bits.INTEDG1 = (PORTBbits.RB1 == GPIO_LOW); // Wait for the opposite edge
+        edge = true;
+    }
+
+    if (INTCON3bits.INT2IF)
+    {
+        INTCON3bits.INT2IF = 0;
+        INTCON2bits.INTEDG2 = (PORTBbits.RB2 == GPIO_LOW);
+        edge = true;
+    }
+
+    if (INTCONbits.RBIF)
+    {
+        (void)PORTB;
+        INTCONbits.RBIF = 0;
+        edge = true;
+    }
+#endif
+    return edge;
+}
+
+//-------------------------------
+// Function: headArrayBspDigitalStates
+//
+// Description: Reads all head array sensors with a single read of PORTB, so they are sampled at the
+//		same instant.
+//
+// Returns: The active pads, see HEAD_ARRAY_PAD_BIT().
+//
+//-------------------------------
+uint8_t headArrayBspDigitalStates(void)
+{
+	// The pads are active low
+	return g_PortToPads[((uint8_t)~PORTB >> PAD_PORT_SHIFT) & PAD_PORT_MASK];
+}
+
+//-------------------------------
+// Function: headArrayBspScanStart
+//
+// Description: Starts converting all proportional pads, one after the other. headArrayBspAdcIsr()
+//		returns true once all are done. Does nothing while a scan is running.
+//
+//-------------------------------
+void headArrayBspScanStart(void)
+{
+#ifdef HEAD_ARRAY_PROPORTIONAL_PADS
+	if (headArrayBspScanDone())
+	{
+#ifndef _18F46K40
+		g_AdcSum = 0;
+		g_AdcSamples = 0;
+#endif
+		g_ScanPad = 0;
+		PAD_ADC_START(g_PadAdcChannel[0]);
+	}
+#endif
+}
+
+//-------------------------------
+// Function: headArrayBspScanDone
+//
+// Description: Checks if the last scan of the proportional pads is done.
+//
+//-------------------------------
+bool headArrayBspScanDone(void)
+{
+#ifdef HEAD_ARRAY_PROPORTIONAL_PADS
+	return (g_ScanPad >= HEAD_ARRAY_SENSOR_EOL);
+#else
+	return true;
+#endif
+}
+
+//-------------------------------
+// Function: headArrayBspProportionalState
+//
+// Description: Returns the reading of a proportional pad from the last scan, 0 to
+//		HEAD_ARRAY_BSP_PROP_MAX. Only valid while no scan is running, see headArrayBspScanDone().
+//
+//-------------------------------
+uint16_t headArrayBspProportionalState(HeadArraySensor_t sensor)
+{
+#ifdef HEAD_ARRAY_PROPORTIONAL_PADS
+	return g_PadAdc[sensor];
+#else
+	(void)sensor;
+	return 0;
+#endif
 }
 
 //-------------------------------
-// Function: headArrayBspDigitalState
+// Function: headArrayBspAdcIsr
+//
+// Description: Stores the end of a pad conversion and starts the next one. Must be called from
+//		the low priority ISR. Each reading is the average of PAD_ADC_OVERSAMPLE conversions, done
+//		by the ADC on the PIC18F46K40 and in software on the PIC18F4550.
 //
-// Description: Reads the digital input state of a single head array sensor.
+// Returns: true at the end of a scan of all pads.
 //
 //-------------------------------
-bool headArrayBspDigitalState(HeadArraySensor_t sensor_id)
+bool headArrayBspAdcIsr(void)
 {
-	switch (sensor_id)
+	bool done = false;
+#ifdef HEAD_ARRAY_PROPORTIONAL_PADS
+	bool next = false;
+
+#ifdef _18F46K40
+	if (PIR1bits.ADTIF)
+	{
+		PIR1bits.ADTIF = 0;
+		g_PadAdc[g_ScanPad] = ADFLTR;
+		next = true;
+	}
+#else
+	if (PIR1bits.ADIF)
+	{
+		PIR1bits.ADIF = 0;
+		g_AdcSum += ADRES;
+		if (++g_AdcSamples < PAD_ADC_OVERSAMPLE)
+		{
+			ADCON0bits.GO = 1;              // Same channel, no new acquisition needed
+		}
+		else
+		{
+			g_PadAdc[g_ScanPad] = g_AdcSum >> PAD_ADC_OVERSAMPLE_SHIFT;
+			g_AdcSum = 0;
+			g_AdcSamples = 0;
+			next = true;
+		}
+	}
+#endif
+
+	if (next)
 	{
-		case HEAD_ARRAY_SENSOR_LEFT:
-			return (PORTBbits.RB1 == DIG_PAD_ACTIVE_STATE);
-
-		case HEAD_ARRAY_SENSOR_CENTER:
-			return (PORTBbits.RB4 == DIG_PAD_ACTIVE_STATE);
-			
-		case HEAD_ARRAY_SENSOR_RIGHT:
-			return (PORTBbits.RB3 == DIG_PAD_ACTIVE_STATE);
-
-        case HEAD_ARRAY_SENSOR_BACK:
-            return (PORTBbits.RB2 == DIG_PAD_ACTIVE_STATE);
-
-		case HEAD_ARRAY_SENSOR_EOL:
-		default:
-			ASSERT(sensor_id == HEAD_ARRAY_SENSOR_CENTER);
-			return false; // Return something.
+		if (++g_ScanPad < HEAD_ARRAY_SENSOR_EOL)
+		{
+			PAD_ADC_START(g_PadAdcChannel[g_ScanPad]);
+		}
+		else
+		{
+			done = true;
+		}
 	}
-    return false;
+#endif
+	return done;
 }
 
 // end of file.
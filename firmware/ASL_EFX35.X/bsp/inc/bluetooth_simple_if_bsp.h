@@ -17,6 +17,7 @@
 /* ***************************    Includes     **************************** */
 
 // from stdlib
+#include <stdint.h>
 #include <stdbool.h>
 
 // from project
@@ -28,6 +29,7 @@ void bluetoothSimpleIfBspInit(void);
 void bluetoothSimpleIfBspPadMirrorDisable(void);
 void bluetoothSimpleIfBspPadMirrorStateSet(HeadArraySensor_t sensor_id, bool active);
 bool bluetoothSimpleIfBspPadMirrorStateGet(HeadArraySensor_t sensor_id);
+void bluetoothSimpleIfBspPadMirrorSet(uint8_t pads);
 
 #endif // BLUETOOTH_SIMPLE_IF_BSP_H
 
@@ -94,6 +94,8 @@ void bspDisableInterrupts(void);
 void bspEnableInterrupts(void);
 void bspDelayUs(uint16_t delay);
 void bspDelayMs(uint16_t delay);
+void bspSysTickIdle(uint32_t num_ticks);
+uint8_t bspSysTickPeriodsElapsed(void);
 
 #endif // BSP_H
 
@@ -24,11 +24,29 @@
 
 /* ******************************   Macros   ****************************** */
 
+// Full scale of a proportional pad reading. Each reading is the average of
+// several 10-bit conversions, see head_array_bsp.c.
+#define HEAD_ARRAY_BSP_PROP_MAX     (1023)
+
+// Default calibration of the proportional pads, as raw readings.
+#define ADC_LEFT_PAD_MIN_VAL		(0)
+#define ADC_LEFT_PAD_MAX_VAL		(HEAD_ARRAY_BSP_PROP_MAX)
+#define ADC_RIGHT_PAD_MIN_VAL		(0)
+#define ADC_RIGHT_PAD_MAX_VAL		(HEAD_ARRAY_BSP_PROP_MAX)
+#define ADC_CTR_PAD_MIN_VAL			(0)
+#define ADC_CTR_PAD_MAX_VAL			(HEAD_ARRAY_BSP_PROP_MAX)
+#define ADC_BACK_PAD_MIN_VAL		(0)
+#define ADC_BACK_PAD_MAX_VAL		(HEAD_ARRAY_BSP_PROP_MAX)
 
 /* ***********************   Function Prototypes   ************************ */
 
 void headArrayBspInit(void);
-bool headArrayBspDigitalState(HeadArraySensor_t sensor_id);
+uint8_t headArrayBspDigitalStates(void);
+bool headArrayBspEdgeIsr(void);
+void headArrayBspScanStart(void);
+bool headArrayBspScanDone(void);
+uint16_t headArrayBspProportionalState(HeadArraySensor_t sensor);
+bool headArrayBspAdcIsr(void);
 
 #endif // HEAD_ARRAY_BSP_H
 
@@ -49,6 +49,9 @@
 #include "os_task.h"
 #include "os_assert.h"
 #include "os_msgqueue.h"
+#include "os_ring.h"
+#include "os_msgpool.h"
+#include "os_trace.h"
 #include "os_applAPI.h"
 
 #ifdef __cplusplus
@@ -61,13 +64,7 @@ extern "C" {
 #define NO_EVENT        255
 #define NO_QUEUE        255
 #define NO_SEM          255
-
-/* Total number of semaphores needed */
-#define N_TOTAL_SEMAPHORES    ( N_SEMAPHORES + N_QUEUES )
-
-
-/* Total number of events needed */
-#define N_TOTAL_EVENTS        ( N_EVENTS + N_QUEUES )
+#define OS_IDLE_FOREVER 0xffffffff
 
 
 
@@ -97,6 +94,12 @@ extern "C" {
 						   	   } while ( 0 )
 
 
+#define OS_WAIT_UNTIL(x,p)	do {\
+								os_task_wait_until_set( running_tid, &(x), p );\
+								OS_SCHEDULE(0);\
+						   	   } while ( 0 )
+
+
 
 extern uint8_t running_tid;
 extern uint8_t last_running_task;
@@ -137,6 +137,38 @@ static void myTask(void) {
 #define task_wait_id(id,x)                OS_WAIT_TICKS(x,id)
 
 
+/*********************************************************************************/
+/*  task_wait_until(x,p)                                                 *//**
+*   
+*   Macro for running a task periodically at fixed release times of the master clock.
+*   The task waits until p ticks after the release time held in x, and x is set to the
+*   new release time. The period does not drift with the run time of the task or with
+*   scheduling delays.
+*
+*   @param x uint32_t variable holding the last release time. Set it with
+*   os_tick_count_get() before the first wait. Must be static, or kept in task data.
+*   @param p Period, in master clock ticks.
+*   @remarks \b Usage: @n If the next release time has already passed, the task does not
+*   wait, the overrun is counted, see task_overruns_get(), and the periods start over
+*   from the current time.
+* @code 
+
+static uint32_t releaseTime;
+
+static void myTask(void) {
+ task_open();
+  releaseTime = os_tick_count_get();
+  for (;;) {
+   ...
+   task_wait_until( releaseTime, 20 );
+  }
+ task_close();
+}
+ @endcode 
+ *******************************************************************************/
+#define task_wait_until(x,p)              OS_WAIT_UNTIL(x,p)
+
+
 /*********************************************************************************/
 /*  task_suspend( id )                                                 *//**
 *   
@@ -292,6 +324,42 @@ static void myTask(void) {
  *******************************************************************************/
 #define event_wait_timeout(event,timeout)    OS_WAIT_SINGLE_EVENT(event,timeout)
 
+/*********************************************************************************/
+/*  event_wait_timeout_unless(event,timeout,condition)                         *//**
+*   
+*   Macro for wait for a single event to be signaled or a timeout to occur, unless the
+*   condition is true. Events are not kept until a task waits for them, so an event
+*   signaled by an ISR just before the wait is lost. When the ISR also sets a flag before
+*   signaling, wait with the flag as the condition: the condition is checked after the
+*   task has started waiting, so either the signal ends the wait, or the flag is seen and
+*   the task only yields.
+*
+*   @param event: the event to wait for
+*   @param timeout: maximum wait time in main clock ticks, 0 for no timeout.
+*   @param condition: expression, true if the task should not wait. Evaluated once.
+*
+*   @remarks \b Usage: @n
+* @code 
+static volatile uint8_t rxPending;
+
+void rxIsr(void) {
+ rxPending = 1;
+ event_ISR_signal( rxEvent );
+}
+
+static void myTask(void) {
+ task_open();	
+  ...
+  rxPending = 0;
+  ...
+  event_wait_timeout_unless( rxEvent, 100, rxPending );
+  ...
+ task_close();
+}
+ @endcode 
+ *******************************************************************************/
+#define event_wait_timeout_unless(event,timeout,condition)    OS_WAIT_SINGLE_EVENT_UNLESS(event,timeout,condition)
+
 /*********************************************************************************/
 /*  event_get_timeout()                                                 *//**
 *
@@ -875,11 +943,15 @@ void os_start( void );
 void os_tick( void );
 void os_sub_tick( uint8_t id );
 void os_sub_nTick( uint8_t id, uint32_t nTicks );
+uint32_t os_idle_ticks_get( void );
+uint32_t os_tick_count_get( void );
 uint8_t os_get_running_tid(void);
 
 uint8_t task_create( taskproctype taskproc, void *data, uint8_t prio, Msg_t* msgPool, uint8_t poolSize, uint16_t msgSize );
 void task_kill( uint8_t tid );
+#ifdef OS_TASK_DATA
 void *task_get_data();
+#endif
 Sem_t sem_bin_create( uint8_t initial );
 Sem_t sem_counting_create( uint8_t max, uint8_t initial );
 
@@ -887,9 +959,23 @@ Evt_t event_create( void );
 uint8_t event_signaling_taskId_get( Evt_t ev );
 TaskState_t task_state_get(uint8_t tid);
 WakeReason_t task_wake_reason(uint8_t tid);
+uint16_t task_overruns_get(uint8_t tid);
+
+#ifdef OS_TASK_STATS
+void task_stats_get(uint8_t tid, TaskStats_t *stats);
+#endif
+
+#ifdef OS_TASK_LATENCY
+void task_latency_get(uint8_t tid, TaskLatency_t *latency);
+#endif
 
 void os_cbkSleep( void );
 
+#ifdef OS_SCHED_TIMING_TEST
+void os_cbkSchedTimingStart( void );
+void os_cbkSchedTimingEnd( void );
+#endif
+
 #ifdef __cplusplus
 }
 #endif
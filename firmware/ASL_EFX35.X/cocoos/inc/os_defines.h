@@ -45,24 +45,91 @@ extern "C" {
 
 #include <stdint.h>
 
+/** Static task table
+* @remarks If defined, the tasks are declared in the OS_TASK_TABLE() X-macro of rtos_task_priorities.h.
+* N_TASKS, N_QUEUES, N_SEMAPHORES and N_EVENTS are counted from the table, the task control blocks are
+* initialized at compile time, and os_init() only creates the message queues and ranks the tasks.
+* Two tasks with the same priority fail the build. task_create() must not be called. If not defined,
+* tasks are created with task_create() and the counts below are set by hand.
+* Always defined on target. With OS_PORT_POSIX the kernel builds on its own, so it is left to the
+* host build, which then puts its own rtos_task_priorities.h on the include path. */
+#if !defined(OS_PORT_POSIX) && !defined(OS_STATIC_TASKS)
+#define OS_STATIC_TASKS
+#endif
+
+
+#ifdef OS_STATIC_TASKS
+#define OS_TASK_COUNT_TASKS(tName, tProc, tPrio, tPeriod, tQueueSize, tMsgSize, tEvents, tSems)     + 1
+#define OS_TASK_COUNT_QUEUES(tName, tProc, tPrio, tPeriod, tQueueSize, tMsgSize, tEvents, tSems)    + ((tQueueSize) > 0)
+#define OS_TASK_COUNT_SEMS(tName, tProc, tPrio, tPeriod, tQueueSize, tMsgSize, tEvents, tSems)      + (tSems)
+#define OS_TASK_COUNT_EVENTS(tName, tProc, tPrio, tPeriod, tQueueSize, tMsgSize, tEvents, tSems)    + (tEvents)
+#endif
+
+
 /** Max number of used tasks
-* @remarks Must be defined. @n Allowed range: 0-254. Value must not be exceeded */
-#define N_TASKS             10
+* @remarks Must be defined. @n Allowed range: 0-254. Value must not be exceeded. Every task costs
+* a task control block of RAM, so this is the number of task_create() calls made at start up. */
+#ifdef OS_STATIC_TASKS
+#define N_TASKS             ( 0 OS_TASK_TABLE(OS_TASK_COUNT_TASKS) )
+#elif defined(N_TASKS)
+/* Set by the host build */
+#elif defined(OS_TRACE)
+#define N_TASKS             7
+#else
+#define N_TASKS             6
+#endif
 
 
 /** Max number of used message queues
-* @remarks Must be defined. @n Allowed range: 0-254. Value must not be exceeded */
-#define N_QUEUES            5
+* @remarks Must be defined. @n Allowed range: 0-254. Value must not be exceeded. With 0 the message
+* queue fields are left out of the task control blocks. */
+#ifdef OS_STATIC_TASKS
+#define N_QUEUES            ( 0 OS_TASK_TABLE(OS_TASK_COUNT_QUEUES) )
+#elif !defined(N_QUEUES)
+#define N_QUEUES            0
+#endif
 
 
 /** Max number of used semaphores
 * @remarks Must be defined. @n Allowed range: 0-254. Value must not be exceeded */
+#ifdef OS_STATIC_TASKS
+#define N_SEMAPHORES        ( 0 OS_TASK_TABLE(OS_TASK_COUNT_SEMS) )
+#elif !defined(N_SEMAPHORES)
 #define N_SEMAPHORES        5
+#endif
 
 
 /** Max number of used events
-* @remarks Must be defined. @n Allowed range: 0-254. Value must not be exceeded */
-#define N_EVENTS            20 // 10
+* @remarks Must be defined. @n Allowed range: 0-254. Value must not be exceeded. Up to 8 events
+* and queues in total keep the event wait mask of each task control block at one byte. */
+#ifdef OS_STATIC_TASKS
+#define N_EVENTS            ( 0 OS_TASK_TABLE(OS_TASK_COUNT_EVENTS) )
+#elif !defined(N_EVENTS)
+#define N_EVENTS            8
+#endif
+
+
+/** Task timeout width
+* @remarks Width in bits, 16 or 32, of the timeout kept in each task control block. With 16 the
+* longest task_wait(), event timeout and task_wait_until() period is OS_TASK_TIME_MAX ticks, about
+* 65 s with the 1 ms tick. The master clock and the periodic release times stay 32 bit. */
+#ifndef OS_TASK_TIME_BITS
+#define OS_TASK_TIME_BITS   16
+#endif
+
+#if (OS_TASK_TIME_BITS == 16)
+#define OS_TASK_TIME_MAX    0xffffUL
+#elif (OS_TASK_TIME_BITS == 32)
+#define OS_TASK_TIME_MAX    0xffffffffUL
+#else
+#error OS_TASK_TIME_BITS must be 16 or 32
+#endif
+
+
+/** Task data pointer
+* @remarks If defined, each task control block keeps the data pointer passed to task_create(), and
+* task_get_data() returns it. If not defined, task_create() must be passed NULL for data. */
+//#define OS_TASK_DATA
 
 
 /** Round Robin scheduling
@@ -70,9 +137,73 @@ extern "C" {
 //#define ROUND_ROBIN
 
 
+/** Scheduler timing test
+* @remarks If defined, os_cbkSchedTimingStart() and os_cbkSchedTimingEnd() are called around the
+* ready task selection in os_schedule(), so the scheduler overhead can be measured on a test GPIO.
+* Works with and without ROUND_ROBIN. */
+//#define OS_SCHED_TIMING_TEST
+
+
+/** Tickless idle
+* @remarks If defined, os_cbkSleep() stretches the tick timer period up to the first timeout while
+* no task is ready, and the skipped ticks are credited by the timer ISR when it wakes up.
+* Off by default: the timer 2 postscaler count can not be read, so after an early wake by another
+* interrupt the master clock stays behind until the long period ends, and timeouts set in that
+* time run up to 15 ms late. Only define it if no task needs timeouts shorter than that. */
+//#define OS_TICKLESS_IDLE
+
+
+/** Task statistics
+* @remarks If defined, the run time, the number of runs and the longest single run of every task
+* are measured around os_task_run() on the free running timer of the port, see os_port.h.
+* Read them with task_stats_get(). */
+//#define OS_TASK_STATS
+
+
+/** Wake-up latency histograms
+* @remarks If defined, the time from a task being made ready until it is run is measured on the
+* same timer as OS_TASK_STATS, and counted in a log2 histogram per task. Bin 0 counts latencies of
+* 0 timer counts, bin n counts latencies of 2^(n-1) to 2^n - 1 counts, and the last bin counts
+* everything longer. Read them with task_latency_get(). */
+//#define OS_TASK_LATENCY
+#define OS_LATENCY_BINS     12
+
+
+/** Kernel trace
+* @remarks If defined, task dispatch and yield, event signals, semaphore take and give and message
+* posts are recorded in a RAM buffer of OS_TRACE_SIZE records, stamped with the same timer as
+* OS_TASK_STATS. Drain it with trace_read(). OS_TRACE_SIZE must be a power of 2, at most 128. */
+//#define OS_TRACE
+#define OS_TRACE_SIZE       32
+
+#if defined(OS_TRACE) && ((OS_TRACE_SIZE > 128) || ((OS_TRACE_SIZE & (OS_TRACE_SIZE - 1)) != 0))
+#error OS_TRACE_SIZE must be a power of 2, at most 128
+#endif
+
+
+/* The task table is included after the options it depends on, it is only expanded where the
+ * counts above are used */
+#ifdef OS_STATIC_TASKS
+#include "rtos_task_priorities.h"
+#endif
+
+
+/* Total number of semaphores needed */
+#define N_TOTAL_SEMAPHORES    ( N_SEMAPHORES + N_QUEUES )
+
+
+/* Total number of events needed. Defined here and not in cocoos.h, so it is known when
+ * os_event.h sizes the event wait mask. */
+#define N_TOTAL_EVENTS        ( N_EVENTS + N_QUEUES )
+
+
 /** Memory size
  * @remarks Should be set to the size of address pointer */
-typedef uint8_t Mem_t;
+#ifdef OS_PORT_POSIX
+typedef uintptr_t Mem_t;
+#else
+typedef uint16_t Mem_t;
+#endif
 
 #define NO_MSG_ID   0xff
 #define ISR_TID     0xfe
@@ -49,6 +49,7 @@ extern "C" {
 #define EVENT_OFS1   10000
 #define EVENT_OFS2   11000
 #define EVENT_OFS3   12000
+#define EVENT_OFS4   13000
 
 #define OS_WAIT_SINGLE_EVENT(x,timeout)	do {\
 								os_wait_event(running_tid,x,1,timeout);\
@@ -56,6 +57,17 @@ extern "C" {
 							   } while (0)
 
 
+/* The condition is checked after the wait is set up, an ISR signal in between ends the wait */
+#define OS_WAIT_SINGLE_EVENT_UNLESS(x,timeout,cond)	do {\
+								os_wait_event(running_tid,x,1,timeout);\
+								if ( cond ) {\
+									os_task_clear_wait_queue(running_tid);\
+									os_task_ready_set(running_tid);\
+								}\
+								OS_SCHEDULE(EVENT_OFS4);\
+							   } while (0)
+
+
 
 
 
@@ -86,19 +98,20 @@ extern "C" {
 
 #define OS_GET_TASK_TIMEOUT_VALUE()  os_task_timeout_get(running_tid)
 
-#ifdef N_TOTAL_EVENTS
-    #define EVENT_QUEUE_SIZE    ((N_TOTAL_EVENTS/9)+1)
+/* Bit mask of the events a task waits for, one bit per event, sized to the number of events */
+#if (N_TOTAL_EVENTS > 32)
+    #error "The event wait mask supports a maximum of 32 events"
+#elif (N_TOTAL_EVENTS > 16)
+    typedef uint32_t EventMask_t;
+#elif (N_TOTAL_EVENTS > 8)
+    typedef uint16_t EventMask_t;
 #else
-    #define EVENT_QUEUE_SIZE    1
+    typedef uint8_t EventMask_t;
 #endif
 
 
 typedef uint8_t Evt_t;
 
-typedef struct {
-    uint8_t eventList[ EVENT_QUEUE_SIZE ];
-} EventQueue_t;
-
 
 void os_event_init(void);
 void os_wait_event( uint8_t tid, Evt_t ev, uint8_t waitSingleEvent, uint32_t timeout );
@@ -0,0 +1,45 @@
+/*
+ * This file is part of the cocoOS port for the ASL head array eFix firmware.
+ */
+/** @file os_msgpool.h Pooled message handle header file */
+
+#ifndef OS_MSGPOOL_H__
+#define OS_MSGPOOL_H__
+
+#include "cocoos.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NO_MSG_HANDLE   255
+
+/* A message handle is the index of a slot in a message pool */
+typedef uint8_t MsgHandle_t;
+
+/* Pool of fixed size message slots. The sender fills a slot in place and posts its one byte
+ * handle, the receiver reads the same slot and frees it. The free list is kept in the first
+ * byte of each free slot, so the pool needs no RAM besides the slots and this struct. */
+typedef struct
+{
+	uint8_t *slots;              ///< Storage for the slots
+	uint16_t slotSize;           ///< Size of one slot, in bytes
+	uint8_t nSlots;              ///< Number of slots
+	uint8_t nFree;               ///< Number of free slots
+	MsgHandle_t freeHead;        ///< First free slot, NO_MSG_HANDLE if none
+	Evt_t event;                 ///< Signaled when a slot is freed, NO_EVENT if none
+} MsgPool_t;
+
+void msg_pool_init( MsgPool_t *pool, void *buffer, uint8_t nSlots, uint16_t slotSize, Evt_t event );
+MsgHandle_t msg_alloc( MsgPool_t *pool );
+void *msg_slot_get( const MsgPool_t *pool, MsgHandle_t handle );
+void msg_free( MsgPool_t *pool, MsgHandle_t handle );
+uint8_t msg_pool_free_count( const MsgPool_t *pool );
+uint8_t msg_handle_post( Ring_t *ring, MsgHandle_t handle );
+MsgHandle_t msg_handle_receive( Ring_t *ring );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -52,7 +52,7 @@ typedef struct {
     uint8_t reserved;   /* Alignment byte */
     uint8_t pad0;
     uint8_t pad1;
-    uint32_t delay;     /* Delay of posting in ticks */
+    uint32_t delay;     /* Master clock tick the message is due at, while queued */
     uint32_t reload;    /* Reload value for periodic messages */
 } Msg_t;
 
@@ -139,7 +139,8 @@ MsgQ_t os_msgQ_create( Msg_t *buffer, uint8_t nMessages, uint16_t msgSize,  uint
 MsgQ_t os_msgQ_find( uint8_t task_id );
 //Sem_t os_msgQ_sem_get( MsgQ_t queue );
 Evt_t os_msgQ_event_get( MsgQ_t queue );
-void os_msgQ_tick( MsgQ_t queue );
+void os_msgQ_tick_all( uint32_t now );
+uint32_t os_msgQ_next_timeout_get( void );
 
 uint8_t os_msg_post( Msg_t *msg, MsgQ_t queue, uint32_t delay, uint32_t period );
 uint8_t os_msg_receive( Msg_t *msg, MsgQ_t queue );
@@ -37,9 +37,54 @@
 #ifndef OS_PORT_H_
 #define OS_PORT_H_
 
+#ifdef OS_PORT_POSIX
+
+/* Host port, see os_port_posix.h. The kernel runs in a single thread and the tick only
+ * advances from os_cbkSleep(), so there is nothing to mask. */
+#include <stdint.h>
+#include "os_port_posix.h"
+
+#define os_enable_interrupts()
+#define os_disable_interrupts()
+
+typedef uint8_t os_irq_state_t;
+
+#define os_critical_enter(s)    do { (s) = 0; } while (0)
+#define os_critical_exit(s)     do { (void)(s); } while (0)
+
+/* Host time in counts of 3.2 us, the same resolution as Timer 1 on target */
+typedef uint16_t os_stats_time_t;
+
+#define os_stats_timer_init()
+#define os_stats_time_get()     os_posix_stats_time_get()
+
+#else
+
  #include <xc.h>
+ #include <stdint.h>
 
 #define os_enable_interrupts() INTCONbits.GIEL = 1; INTCONbits.GIEH = 1
 #define os_disable_interrupts() INTCONbits.GIEL = 0; INTCONbits.GIEH = 0
 
+/* Short critical sections around kernel data shared with the tick ISR. GIEH = 0 masks
+ * both interrupt levels, and the previous state is restored so these nest inside an ISR. */
+typedef uint8_t os_irq_state_t;
+
+#define os_critical_enter(s)    do { (s) = INTCONbits.GIEH; INTCONbits.GIEH = 0; } while (0)
+#define os_critical_exit(s)     do { INTCONbits.GIEH = (s); } while (0)
+
+/* Time base for the task statistics (OS_TASK_STATS). Timer 1 runs free from Fosc/4 with a /8
+ * prescaler, which is 3.2 us per count at 10 MHz and wraps after 209 ms. */
+typedef uint16_t os_stats_time_t;
+
+#ifdef _18F46K40
+#define os_stats_timer_init()   do { T1CON = 0; T1CLK = 0x01; T1CONbits.CKPS = 3; T1CONbits.RD16 = 1; TMR1H = 0; TMR1L = 0; T1CONbits.ON = 1; } while (0)
+#else
+#define os_stats_timer_init()   do { T1CON = 0; T1CONbits.T1CKPS = 3; T1CONbits.RD16 = 1; TMR1H = 0; TMR1L = 0; T1CONbits.TMR1ON = 1; } while (0)
+#endif
+
+#define os_stats_time_get()     ((os_stats_time_t)TMR1)
+
+#endif
+
 #endif
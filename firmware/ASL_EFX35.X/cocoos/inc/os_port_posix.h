@@ -0,0 +1,54 @@
+/*
+ * This file is part of the cocoOS port for the ASL head array eFix firmware.
+ */
+/** @file os_port_posix.h POSIX host port header file */
+
+#ifndef OS_PORT_POSIX_H__
+#define OS_PORT_POSIX_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Host port of cocoOS, selected by defining OS_PORT_POSIX. The master clock is a virtual
+ * clock: it only advances in os_cbkSleep(), and then straight to the next task timeout or
+ * message deadline, so hours of simulated time run in seconds. A task that never waits
+ * stops the virtual clock, as it would starve the other tasks on target.
+ *
+ * Only the kernel is ported. Application code that touches PIC registers must be replaced
+ * by host stubs. OS_STATIC_TASKS is not defined on the host unless the build asks for it,
+ * so the kernel does not need the task table of the application. Build the kernel with
+ *
+ *   gcc -DOS_PORT_POSIX -Icocoos/inc cocoos/src/[all .c files] sim_main.c
+ *
+ * where sim_main.c creates the tasks and drives the simulation:
+ *
+ *   os_init();
+ *   task_create( ledTask, NULL, 1, NULL, 0, 0 );
+ *   os_posix_tick_hook_set( inputStimulus );
+ *   os_posix_run_for( 60UL * 60 * 1000 );
+ *
+ * The task and kernel object counts default to those of os_defines.h, and can be set on
+ * the command line, e.g. -DN_TASKS=3. With -DOS_STATIC_TASKS the tasks are instead taken
+ * from the OS_TASK_TABLE() of an rtos_task_priorities.h that the build puts on the include
+ * path, and task_create() is not called.
+ *
+ * The host tests of the kernel are in cocoos/test, run them with make -C cocoos/test.
+ */
+
+void os_posix_run_for( uint32_t ticks );
+void os_posix_tick_hook_set( void (*hook)( uint32_t now ) );
+uint32_t os_posix_wakeups_get( void );
+void os_posix_sleep( void );
+uint16_t os_posix_stats_time_get( void );
+
+/* Implemented in os_kernel.c */
+void os_run_until_tick( uint32_t tick );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,39 @@
+/*
+ * This file is part of the cocoOS port for the ASL head array eFix firmware.
+ */
+/** @file os_ring.h Single producer, single consumer ring buffer header file */
+
+#ifndef OS_RING_H__
+#define OS_RING_H__
+
+#include "cocoos.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Ring buffer for passing fixed size elements from one producer to one consumer, without
+ * disabling interrupts. The producer only writes head and the consumer only writes tail.
+ * Both are single bytes, so they are read and written atomically on an 8-bit MCU. head and
+ * tail are free running counts, and the number of elements must be a power of 2, at most 128. */
+typedef struct
+{
+	uint8_t *buffer;             ///< Storage for the elements
+	uint8_t mask;                ///< Number of elements - 1
+	uint8_t elementSize;         ///< Size of one element, in bytes
+	Evt_t event;                 ///< Signaled on every push, NO_EVENT if none
+	volatile uint8_t head;       ///< Number of elements pushed, only written by the producer
+	volatile uint8_t tail;       ///< Number of elements popped, only written by the consumer
+} Ring_t;
+
+void ring_init( Ring_t *ring, void *buffer, uint8_t nElements, uint8_t elementSize, Evt_t event );
+uint8_t ring_push( Ring_t *ring, const void *element );
+uint8_t ring_ISR_push( Ring_t *ring, const void *element );
+uint8_t ring_pop( Ring_t *ring, void *element );
+uint8_t ring_count( const Ring_t *ring );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -59,12 +59,48 @@ typedef enum {
     KILLED
 } TaskState_t;
 
+/* Task timeout, see OS_TASK_TIME_BITS */
+#if (OS_TASK_TIME_BITS == 16)
+typedef uint16_t TaskTime_t;
+#else
+typedef uint32_t TaskTime_t;
+#endif
+
 typedef enum {
     WAKE_REASON_OS_NONE,
     WAKE_REASON_OS_EVENT,
     WAKE_REASON_OS_TIMEOUT
 } WakeReason_t;
 
+#ifdef OS_TASK_STATS
+typedef struct {
+    uint32_t runTime;               ///< Total run time, in os_stats_time_t counts
+    uint32_t runCount;              ///< Number of times the task has been run
+    os_stats_time_t maxRunTime;     ///< Longest single run, in os_stats_time_t counts
+} TaskStats_t;
+#endif
+
+#ifdef OS_TASK_LATENCY
+typedef struct {
+    uint16_t bins[OS_LATENCY_BINS]; ///< Number of wake-ups per latency bin, saturates at 0xffff
+    os_stats_time_t maxLatency;     ///< Longest latency, in os_stats_time_t counts
+} TaskLatency_t;
+#endif
+
+
+#ifdef OS_STATIC_TASKS
+/* Task ids and task procedures of OS_TASK_TABLE. The id is the position in the table. */
+#define OS_TASK_ID(tName, tProc, tPrio, tPeriod, tQueueSize, tMsgSize, tEvents, tSems)      tName##_TASK_ID,
+#define OS_TASK_PROC(tName, tProc, tPrio, tPeriod, tQueueSize, tMsgSize, tEvents, tSems)    void tProc(void);
+
+enum {
+    OS_TASK_TABLE(OS_TASK_ID)
+    OS_TASK_TABLE_END
+};
+
+OS_TASK_TABLE(OS_TASK_PROC)
+#endif
+
 
 #define TASK_OFS1    30000
 #define TASK_OFS2    31000
@@ -114,6 +150,10 @@ Evt_t os_task_get_change_event(uint8_t tid);
 void os_task_set_msg_result(uint8_t tid, uint8_t result);
 uint8_t os_task_get_msg_result(uint8_t tid);
 uint32_t os_task_timeout_get(uint8_t tid);
+uint32_t os_task_next_timeout_get(void);
+uint32_t os_task_clock_get(void);
+void os_task_wait_until_set(uint8_t tid, uint32_t *release, uint32_t period);
+uint16_t os_task_overruns_get(uint8_t tid);
 
 
 
@@ -0,0 +1,48 @@
+/*
+ * This file is part of the cocoOS port for the ASL head array eFix firmware.
+ */
+/** @file os_trace.h Kernel trace header file */
+
+#ifndef OS_TRACE_H__
+#define OS_TRACE_H__
+
+#include "cocoos.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Kinds of trace records, the id of the record is given for each */
+enum {
+	TRACE_TASK_DISPATCH = 1,     ///< Task id, the task is run
+	TRACE_TASK_YIELD,            ///< Task id, the task returned to the scheduler
+	TRACE_EVENT_SIGNAL,          ///< Event id
+	TRACE_SEM_TAKE,              ///< Semaphore id
+	TRACE_SEM_GIVE,              ///< Semaphore id
+	TRACE_MSG_POST               ///< Message queue id
+};
+
+/* One trace record. time is read from the free running timer of the port, see os_port.h. */
+typedef struct
+{
+	uint8_t type;
+	uint8_t id;
+	uint16_t time;
+} TraceRecord_t;
+
+#ifdef OS_TRACE
+#define os_trace(type, id)      os_trace_record(type, id)
+#else
+#define os_trace(type, id)
+#endif
+
+void os_trace_init( void );
+void os_trace_record( uint8_t type, uint8_t id );
+uint8_t trace_read( TraceRecord_t *record );
+uint8_t trace_lost_get( void );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
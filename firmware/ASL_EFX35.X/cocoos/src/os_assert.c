@@ -35,6 +35,16 @@
 
 #include "cocoos.h"
 
+#ifdef OS_PORT_POSIX
+#include <stdio.h>
+#include <stdlib.h>
+
+void os_on_assert(uint16_t line)
+{
+	fprintf(stderr, "cocoOS assert at line %u\n", line);
+	abort();
+}
+#else
 void os_on_assert(uint16_t line)
 {
 	static volatile uint16_t l;
@@ -46,4 +56,4 @@ void os_on_assert(uint16_t line)
 	{
 	}
 }
-
+#endif
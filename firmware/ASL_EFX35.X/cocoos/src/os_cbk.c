@@ -35,17 +35,72 @@
 
 #include "cocoos.h"
 
+#ifdef OS_SCHED_TIMING_TEST
+#include "test_gpio.h"
+#endif
+
+#if defined(OS_TICKLESS_IDLE) && !defined(OS_PORT_POSIX)
+#include "bsp.h"
+#endif
+
 /************************************************************** *******************/
 /*  void os_cbkSleep( void )    *//**
  *   Callback called by the os kernel when all tasks are in waiting state. Here you
  *   can put the MCU to low power mode. Remember to keep the clock running so we can
  *	wake up from sleep.
  *
- *
+ *   With OS_TICKLESS_IDLE the CPU idles until the first task timeout, and the tick
+ *   timer only interrupts once for the whole idle time. With OS_PORT_POSIX the
+ *   virtual clock advances to the first timeout.
  *
  */
 /*********************************************************************************/
 void os_cbkSleep(void)
 {
-	/* Enter low power mode here */
+#if defined(OS_PORT_POSIX)
+	/* No time passes on the host while idling, the virtual clock jumps to the next timeout */
+	os_posix_sleep();
+#elif defined(OS_TICKLESS_IDLE)
+	uint32_t ticks;
+
+	/* With interrupts disabled, a task made ready by an ISR after the scheduler looked is not missed */
+	bspDisableInterrupts();
+
+	ticks = os_idle_ticks_get();
+
+	if (ticks != 0)
+	{
+		bspSysTickIdle(ticks);
+	}
+
+	/* The tick ISR runs here and credits the idle ticks */
+	bspEnableInterrupts();
+#endif
+}
+
+#ifdef OS_SCHED_TIMING_TEST
+/************************************************************** *******************/
+/*  void os_cbkSchedTimingStart( void )    *//**
+ *   Callback called by the os kernel before it selects the next task to run.
+ *   TEST_GPIO_1 is high while the selection runs; measure the pulse width with a
+ *   scope, once with and once without ROUND_ROBIN defined.
+ *
+ */
+/*********************************************************************************/
+void os_cbkSchedTimingStart(void)
+{
+	testGpioSet(TEST_GPIO_1, true);
 }
+
+/************************************************************** *******************/
+/*  void os_cbkSchedTimingEnd( void )    *//**
+ *   Callback called by the os kernel when the next task to run has been selected.
+ *
+ */
+/*********************************************************************************/
+void os_cbkSchedTimingEnd(void)
+{
+	testGpioSet(TEST_GPIO_1, false);
+}
+#endif
+
@@ -173,8 +173,11 @@ void os_wait_event(uint8_t tid, Evt_t ev, uint8_t waitSingleEvent, uint32_t time
 
 void os_signal_event(Evt_t ev)
 {
+#if (N_TOTAL_EVENTS > 0)
 	lastSignaledEvent = ev;
+	os_trace(TRACE_EVENT_SIGNAL, ev);
 	os_task_signal_event(ev);
+#endif
 }
 
 void os_event_set_signaling_tid(Evt_t ev, uint8_t tid)
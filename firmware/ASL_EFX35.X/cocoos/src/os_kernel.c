@@ -71,12 +71,21 @@ void os_init(void)
 	os_event_init();
 	os_msgQ_init();
 	os_task_init();
+	os_trace_init();
+
+#if defined(OS_TASK_STATS) || defined(OS_TASK_LATENCY) || defined(OS_TRACE)
+	os_stats_timer_init();
+#endif
 }
 
 static void os_schedule(void)
 {
 	running_tid = NO_TID;
 
+#ifdef OS_SCHED_TIMING_TEST
+	os_cbkSchedTimingStart();
+#endif
+
 #ifdef ROUND_ROBIN
 	/* Find next ready task */
 	running_tid = os_task_next_ready_task();
@@ -85,6 +94,10 @@ static void os_schedule(void)
 	running_tid = os_task_highest_prio_ready_task();
 #endif
 
+#ifdef OS_SCHED_TIMING_TEST
+	os_cbkSchedTimingEnd();
+#endif
+
 	if (running_tid != NO_TID)
 	{
 		os_task_run();
@@ -211,6 +224,73 @@ void os_sub_nTick(uint8_t id, uint32_t nTicks)
 	}
 }
 
+/*********************************************************************************/
+/*  uint32_t os_idle_ticks_get()                                              *//**
+ *
+ *   Gets the number of master clock ticks the system can sleep before a task must run.
+ *
+ *   @return 0 if a task is ready to run, 1 if no tick can be skipped, OS_IDLE_FOREVER if no task
+ *   is waiting for a timeout, otherwise the number of ticks until the first timeout.
+ *   @remarks \b Usage: @n Called from os_cbkSleep() with interrupts disabled, to decide how long
+ *   the tick timer may run before it interrupts. Delayed and periodic messages count
+ *   as timeouts too.
+ *
+ *   @code
+ *   void os_cbkSleep( void ) {
+ *     uint32_t ticks;
+ *     disable_interrupts();
+ *     ticks = os_idle_ticks_get();
+ *     if ( ticks != 0 ) {
+ *       sleep_for( ticks );
+ *     }
+ *     enable_interrupts();
+ *   }
+ *
+ *   @endcode
+ *
+ */
+/*********************************************************************************/
+uint32_t os_idle_ticks_get(void)
+{
+	uint32_t ticks;
+	uint32_t msgTicks;
+
+	if (NO_TID != os_task_highest_prio_ready_task())
+	{
+		return(0);
+	}
+
+	ticks = os_task_next_timeout_get();
+	msgTicks = os_msgQ_next_timeout_get();
+
+	if ((0 != msgTicks) && ((0 == ticks) || (msgTicks < ticks)))
+	{
+		ticks = msgTicks;
+	}
+
+	if (0 == ticks)
+	{
+		ticks = OS_IDLE_FOREVER;
+	}
+
+	return(ticks);
+}
+
+/*********************************************************************************/
+/*  uint32_t os_tick_count_get()                                              *//**
+ *
+ *   Gets the number of master clock ticks since os_init().
+ *
+ *   @return Master clock tick count, wraps around at 2^32.
+ *   @remarks \b Usage: @n Used to set the first release time of task_wait_until().
+ *
+ */
+/*********************************************************************************/
+uint32_t os_tick_count_get(void)
+{
+	return(os_task_clock_get());
+}
+
 uint8_t os_running(void)
 {
 	return(running);
@@ -221,6 +301,21 @@ uint8_t os_get_running_tid(void)
 	return(running_tid);
 }
 
+#ifdef OS_PORT_POSIX
+/* Runs the scheduler until the master clock reaches tick, see os_posix_run_for() */
+void os_run_until_tick(uint32_t tick)
+{
+	running = 1;
+	os_enable_interrupts();
+
+	while ((int32_t)(tick - os_task_clock_get()) > 0)
+	{
+		os_schedule();
+	}
+}
+
+#endif
+
 #ifdef UNIT_TEST
 void os_run()
 {
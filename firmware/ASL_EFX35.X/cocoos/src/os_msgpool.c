@@ -0,0 +1,212 @@
+/*
+ * This file is part of the cocoOS port for the ASL head array eFix firmware.
+ */
+/** @file os_msgpool.c Pooled message handle source file */
+
+#include "cocoos.h"
+
+// Suppress "function is never called" warning for this file.
+#pragma warning disable 520
+
+/*********************************************************************************/
+/*  void msg_pool_init( MsgPool_t *pool, void *buffer, uint8_t nSlots, uint16_t slotSize, Evt_t event )    *//**
+ *
+ *   Initializes a message pool with all slots free.
+ *
+ *   @param pool Pool to initialize.
+ *   @param buffer Storage for nSlots slots of slotSize bytes.
+ *   @param nSlots Number of slots, 1 - 254.
+ *   @param slotSize Size of one slot, in bytes.
+ *   @param event Event signaled when a slot is freed, NO_EVENT if none.
+ *   @return None
+ *
+ *   @remarks \b Usage: @n Messages are not copied. The sender allocates a slot, fills it in
+ *   place and posts the handle to a Ring_t of MsgHandle_t. The receiver gets the same slot
+ *   from the handle and frees it when done. Delayed and periodic messages are not supported,
+ *   use the task message queues for those.
+ *
+ *   @code
+ *   static MsgPool_t ledPool;
+ *   static LedMsg_t ledSlots[ 4 ];
+ *   static Ring_t ledRing;
+ *   static MsgHandle_t ledHandles[ 4 ];
+ *
+ *   msg_pool_init( &ledPool, ledSlots, 4, sizeof(LedMsg_t), NO_EVENT );
+ *   ring_init( &ledRing, ledHandles, 4, sizeof(MsgHandle_t), event_create() );
+ *   @endcode
+ *
+ */
+/*********************************************************************************/
+void msg_pool_init(MsgPool_t *pool, void *buffer, uint8_t nSlots, uint16_t slotSize, Evt_t event)
+{
+	uint8_t i;
+
+	os_assert(nSlots != 0);
+	os_assert(nSlots < NO_MSG_HANDLE);
+	os_assert(slotSize != 0);
+
+	pool->slots = (uint8_t *)buffer;
+	pool->slotSize = slotSize;
+	pool->nSlots = nSlots;
+	pool->nFree = nSlots;
+	pool->freeHead = 0;
+	pool->event = event;
+
+	/* Link the slots into the free list */
+	for (i = 0; i != nSlots - 1; ++i)
+	{
+		pool->slots[(uint16_t)i * slotSize] = i + 1;
+	}
+
+	pool->slots[(uint16_t)i * slotSize] = NO_MSG_HANDLE;
+}
+
+/*********************************************************************************/
+/*  MsgHandle_t msg_alloc( MsgPool_t *pool )    *//**
+ *
+ *   Allocates a slot from the pool.
+ *
+ *   @param pool Pool to allocate from.
+ *   @return Handle of the slot, NO_MSG_HANDLE if all slots are in use.
+ *
+ *   @remarks \b Usage: @n Can be called from a task or an ISR. If the pool was created
+ *   with an event, a task can wait for it when no slot is free.
+ *
+ *   @code
+ *   MsgHandle_t h;
+ *
+ *   while ( NO_MSG_HANDLE == (h = msg_alloc( &ledPool )) ) {
+ *     event_wait( ledPoolEvent );
+ *   }
+ *
+ *   LedMsg_t *msg = msg_slot_get( &ledPool, h );
+ *   msg->led = LED_GREEN;
+ *   msg_handle_post( &ledRing, h );
+ *   @endcode
+ *
+ */
+/*********************************************************************************/
+MsgHandle_t msg_alloc(MsgPool_t *pool)
+{
+	os_irq_state_t irq;
+	MsgHandle_t handle;
+
+	os_critical_enter(irq);
+
+	handle = pool->freeHead;
+
+	if (NO_MSG_HANDLE != handle)
+	{
+		pool->freeHead = pool->slots[(uint16_t)handle * pool->slotSize];
+		pool->nFree--;
+	}
+
+	os_critical_exit(irq);
+
+	return(handle);
+}
+
+/* Gets a pointer to the slot of a handle */
+void *msg_slot_get(const MsgPool_t *pool, MsgHandle_t handle)
+{
+	os_assert(handle < pool->nSlots);
+
+	return(pool->slots + (uint16_t)handle * pool->slotSize);
+}
+
+/*********************************************************************************/
+/*  void msg_free( MsgPool_t *pool, MsgHandle_t handle )    *//**
+ *
+ *   Returns a slot to the pool. The pool event, if any, is signaled with the running
+ *   task as the signaling task.
+ *
+ *   @param pool Pool the slot was allocated from.
+ *   @param handle Handle of the slot. The slot must not be used after this call.
+ *   @return None
+ *
+ *   @remarks \b Usage: @n Called from a task, by the receiver when it is done with the
+ *   message.
+ *
+ *   @code
+ *   MsgHandle_t h;
+ *
+ *   h = msg_handle_receive( &ledRing );
+ *   if ( NO_MSG_HANDLE != h ) {
+ *     LedMsg_t *msg = msg_slot_get( &ledPool, h );
+ *     led_set( msg->led );
+ *     msg_free( &ledPool, h );
+ *   }
+ *   @endcode
+ *
+ */
+/*********************************************************************************/
+void msg_free(MsgPool_t *pool, MsgHandle_t handle)
+{
+	os_irq_state_t irq;
+
+	os_assert(handle < pool->nSlots);
+
+	os_critical_enter(irq);
+
+	pool->slots[(uint16_t)handle * pool->slotSize] = pool->freeHead;
+	pool->freeHead = handle;
+	pool->nFree++;
+
+	os_critical_exit(irq);
+
+	if (NO_EVENT != pool->event)
+	{
+		os_signal_event(pool->event);
+		os_event_set_signaling_tid(pool->event, running_tid);
+	}
+}
+
+/* Gets the number of free slots in the pool */
+uint8_t msg_pool_free_count(const MsgPool_t *pool)
+{
+	return(pool->nFree);
+}
+
+/*********************************************************************************/
+/*  uint8_t msg_handle_post( Ring_t *ring, MsgHandle_t handle )    *//**
+ *
+ *   Posts a handle to a ring of MsgHandle_t, from a task. Only the one byte handle is
+ *   copied, the message stays in its slot.
+ *
+ *   @param ring Ring created with elementSize sizeof(MsgHandle_t).
+ *   @param handle Handle of a filled in slot.
+ *   @return 1 if the handle was posted, 0 if the ring is full. The slot is still owned
+ *   by the sender if the ring is full.
+ *
+ */
+/*********************************************************************************/
+uint8_t msg_handle_post(Ring_t *ring, MsgHandle_t handle)
+{
+	os_assert(ring->elementSize == sizeof(MsgHandle_t));
+
+	return(ring_push(ring, &handle));
+}
+
+/*********************************************************************************/
+/*  MsgHandle_t msg_handle_receive( Ring_t *ring )    *//**
+ *
+ *   Receives the oldest handle posted to a ring of MsgHandle_t.
+ *
+ *   @param ring Ring created with elementSize sizeof(MsgHandle_t).
+ *   @return Handle of the posted slot, NO_MSG_HANDLE if the ring is empty.
+ *
+ */
+/*********************************************************************************/
+MsgHandle_t msg_handle_receive(Ring_t *ring)
+{
+	MsgHandle_t handle;
+
+	os_assert(ring->elementSize == sizeof(MsgHandle_t));
+
+	if (0 == ring_pop(ring, &handle))
+	{
+		handle = NO_MSG_HANDLE;
+	}
+
+	return(handle);
+}
@@ -58,12 +58,21 @@ typedef struct
 
 #if (N_QUEUES > 0)
 
-static uint8_t MsgQAllDelayed(OSQueue_t *q);
+static uint8_t MsgQAllDelayed(OSQueue_t *q, uint32_t now);
 static uint8_t queue_push(OSQueue_t *queue, Msg_t *msg);
+static void msg_timer_arm(uint32_t due);
 
 /* List of task message queues */
 static OSMsgQ_t msgQList[N_QUEUES];
 static MsgQ_t nQueues;
+
+/* While a message is in a queue, its delay field holds the master clock tick it is due at.
+ * msgNextDue is the earliest due tick of the messages not yet due, valid if msgTimerArmed is
+ * set, so ticks when no message falls due cost a single compare. */
+static uint32_t msgNextDue;
+static uint8_t msgTimerArmed;
+
+#define MSG_DUE(pMsg, now)    ((int32_t)((now) - (pMsg)->delay) >= 0)
 #endif
 
 void os_msgQ_init(void)
@@ -71,6 +80,8 @@ void os_msgQ_init(void)
 #if (N_QUEUES > 0)
 	uint8_t i;
 	nQueues = 0;
+	msgNextDue = 0;
+	msgTimerArmed = 0;
 
 	for (i = 0; i < N_QUEUES; ++i)
 	{
@@ -147,15 +158,30 @@ uint8_t os_msg_post(Msg_t *msg, MsgQ_t queue, uint32_t delay, uint32_t period)
 		return(MSG_QUEUE_UNDEF);
 	}
 
-	msg->delay = delay;
+	uint8_t result;
+
+	msg->delay = os_task_clock_get() + delay;
 	msg->reload = period;
-	return(queue_push(&msgQList[queue].q, msg));
+	result = queue_push(&msgQList[queue].q, msg);
+
+	if (MSG_QUEUE_POSTED == result)
+	{
+		os_trace(TRACE_MSG_POST, queue);
+
+		if (delay > 0)
+		{
+			msg_timer_arm(msg->delay);
+		}
+	}
+
+	return(result);
 
 #else
 	return(0);
 #endif
 }
 
+#if (N_QUEUES > 0)
 static uint8_t queue_push(OSQueue_t *queue, Msg_t *msg)
 {
 	if (0 == queue->size)
@@ -184,6 +210,7 @@ static uint8_t queue_push(OSQueue_t *queue, Msg_t *msg)
 
 	return(MSG_QUEUE_POSTED);
 }
+#endif
 
 uint8_t os_msg_receive(Msg_t *msg, MsgQ_t queue)
 {
@@ -192,6 +219,7 @@ uint8_t os_msg_receive(Msg_t *msg, MsgQ_t queue)
 	OSQueue_t *q;
 	uint8_t *src;
 	uint8_t found;
+	uint32_t now;
 
 	if (queue >= nQueues)
 	{
@@ -206,8 +234,10 @@ uint8_t os_msg_receive(Msg_t *msg, MsgQ_t queue)
 		return(MSG_QUEUE_EMPTY);
 	}
 
-	/* If all messages have a delay > 0 we consider the queue as empty */
-	if (MsgQAllDelayed(q) == 1)
+	now = os_task_clock_get();
+
+	/* If no message is due we consider the queue as empty */
+	if (MsgQAllDelayed(q, now) == 1)
 	{
 		return(MSG_QUEUE_EMPTY);
 	}
@@ -232,18 +262,18 @@ uint8_t os_msg_receive(Msg_t *msg, MsgQ_t queue)
 		msgSz = q->messageSize;
 
 		uint8_t messagePeriodic = (msg->reload > 0);
-		uint8_t messageTimedOut = (msg->delay == 0);
+		uint8_t messageTimedOut = MSG_DUE(msg, now);
 
 		if (messageTimedOut)
 		{
 			found = 1;
 			if (messagePeriodic)
 			{
-				msg->delay = msg->reload;
+				msg->delay = now + msg->reload;
 			}
 		}
 
-		/* Put the message back at head position if delay > 0, or if it is a periodic message that timed out */
+		/* Put the message back at head position if it is not due, or if it is a periodic message that timed out */
 		if ((!messageTimedOut) || (messagePeriodic && messageTimedOut))
 		{
 			dst = (uint8_t *)((Mem_t)q->list + q->head * msgSz);
@@ -259,50 +289,120 @@ uint8_t os_msg_receive(Msg_t *msg, MsgQ_t queue)
 
 			/* Look for buffer wrap around */
 			q->head = (q->head + 1) % q->size;
+
+			/* The tick may have scanned the queue while the message was moved */
+			msg_timer_arm(msg->delay);
 		}
 	}
 
 	q->tail = tail;
 
+	/* The due tick means nothing to the receiver */
+	msg->delay = 0;
+
 	return(MSG_QUEUE_RECEIVED);
 #else
 	return(0);
 #endif
 }
 
-void os_msgQ_tick(MsgQ_t queue)
+/*********************************************************************************/
+/*  void os_msgQ_tick_all( uint32_t now )    *//**
+ *
+ *   Signals the queues holding messages that have fallen due, and finds the next due tick.
+ *
+ *   @param now Master clock tick count.
+ *   @return None
+ *
+ *   @remarks \b Usage: @n Called from os_task_tick() on every master clock tick. Only
+ *   the ticks when a delayed or periodic message falls due scan the queues.
+ *
+ */
+/*********************************************************************************/
+void os_msgQ_tick_all(uint32_t now)
 {
 #if (N_QUEUES > 0)
+	MsgQ_t queue;
 	uint8_t nextMessage;
+	uint8_t head;
+	uint8_t due;
 	Msg_t *pMsg;
-	OSQueue_t *q = &msgQList[queue].q;
-	nextMessage = (q->tail + 1) % q->size;
+	OSQueue_t *q;
 
-	uint8_t head = q->head;
-	uint16_t msgSz = q->messageSize;
+	if ((0 == msgTimerArmed) || ((int32_t)(now - msgNextDue) < 0))
+	{
+		return;
+	}
 
-	while (nextMessage != head)
+	msgTimerArmed = 0;
+
+	for (queue = 0; queue != nQueues; ++queue)
 	{
-		pMsg = (Msg_t *)((Mem_t)q->list + nextMessage * msgSz);
+		q = &msgQList[queue].q;
+		nextMessage = (q->tail + 1) % q->size;
+		head = q->head;
+		due = 0;
 
-		if (pMsg->delay > 0)
+		while (nextMessage != head)
 		{
-			--(pMsg->delay);
-			if (pMsg->delay == 0)
+			pMsg = (Msg_t *)((Mem_t)q->list + nextMessage * q->messageSize);
+
+			if (MSG_DUE(pMsg, now))
 			{
-				event_ISR_signal(msgQList[queue].change);
+				due = 1;
 			}
+			else if ((0 == msgTimerArmed) || ((int32_t)(pMsg->delay - msgNextDue) < 0))
+			{
+				msgNextDue = pMsg->delay;
+				msgTimerArmed = 1;
+			}
+
+			nextMessage = (nextMessage + 1) % q->size;
 		}
 
-		nextMessage = (nextMessage + 1) % q->size;
+		if (due)
+		{
+			event_ISR_signal(msgQList[queue].change);
+		}
 	}
 
 #endif
 }
 
+/* Returns the number of ticks until the next delayed or periodic message falls due, 0 if none */
+uint32_t os_msgQ_next_timeout_get(void)
+{
 #if (N_QUEUES > 0)
+	uint32_t ticks;
+	uint32_t now;
+	os_irq_state_t irq;
+
+	now = os_task_clock_get();
+	ticks = 0;
+
+	os_critical_enter(irq);
+
+	if (msgTimerArmed)
+	{
+		ticks = 1;
+
+		if ((int32_t)(msgNextDue - now) > 0)
+		{
+			ticks = msgNextDue - now;
+		}
+	}
+
+	os_critical_exit(irq);
 
-static uint8_t MsgQAllDelayed(OSQueue_t *q)
+	return(ticks);
+#else
+	return(0);
+#endif
+}
+
+#if (N_QUEUES > 0)
+
+static uint8_t MsgQAllDelayed(OSQueue_t *q, uint32_t now)
 {
 	uint32_t nextMessage;
 	Msg_t *pMsg;
@@ -317,7 +417,7 @@ static uint8_t MsgQAllDelayed(OSQueue_t *q)
 	{
 		pMsg = (Msg_t *)((Mem_t)q->list + (nextMessage * msgSz));
 
-		if (pMsg->delay == 0)
+		if (MSG_DUE(pMsg, now))
 		{
 			result = 0;
 			break;
@@ -329,4 +429,20 @@ static uint8_t MsgQAllDelayed(OSQueue_t *q)
 	return(result);
 }
 
+/* Makes the tick signal the queues when the master clock reaches due */
+static void msg_timer_arm(uint32_t due)
+{
+	os_irq_state_t irq;
+
+	os_critical_enter(irq);
+
+	if ((0 == msgTimerArmed) || ((int32_t)(due - msgNextDue) < 0))
+	{
+		msgNextDue = due;
+		msgTimerArmed = 1;
+	}
+
+	os_critical_exit(irq);
+}
+
 #endif
@@ -0,0 +1,115 @@
+/*
+ * This file is part of the cocoOS port for the ASL head array eFix firmware.
+ */
+/** @file os_port_posix.c POSIX host port source file */
+
+#ifdef OS_PORT_POSIX
+
+/* clock_gettime() and CLOCK_MONOTONIC are not declared by a strict -std=c99 build without it */
+#define _POSIX_C_SOURCE 199309L
+
+#include <stddef.h>
+#include <time.h>
+#include "cocoos.h"
+
+static uint32_t stopTick;
+static uint32_t wakeups;
+static void (*tickHook)(uint32_t now);
+
+/*********************************************************************************/
+/*  void os_posix_run_for( uint32_t ticks )    *//**
+ *
+ *   Runs the tasks until the virtual master clock has advanced by ticks.
+ *
+ *   @param ticks Number of master clock ticks to simulate.
+ *   @return None
+ *
+ *   @remarks \b Usage: @n Called from the simulation main() after os_init() and
+ *   task_create(), instead of os_start(). Can be called repeatedly to simulate in steps.
+ *
+ */
+/*********************************************************************************/
+void os_posix_run_for(uint32_t ticks)
+{
+	stopTick = os_tick_count_get() + ticks;
+	os_run_until_tick(stopTick);
+}
+
+/*********************************************************************************/
+/*  void os_posix_tick_hook_set( void (*hook)( uint32_t now ) )    *//**
+ *
+ *   Sets a function called each time the virtual clock advances, like the tick ISR
+ *   on target. Simulated inputs can be applied here.
+ *
+ *   @param hook Function called with the new master clock tick count, NULL for none.
+ *   @return None
+ *
+ */
+/*********************************************************************************/
+void os_posix_tick_hook_set(void (*hook)(uint32_t now))
+{
+	tickHook = hook;
+}
+
+/* Gets the number of times the virtual clock has advanced, the host count of tick interrupts */
+uint32_t os_posix_wakeups_get(void)
+{
+	return(wakeups);
+}
+
+/*********************************************************************************/
+/*  void os_posix_sleep( void )    *//**
+ *
+ *   Advances the virtual clock to the first task timeout or message deadline, but not
+ *   past the end of the current os_posix_run_for().
+ *
+ *   @return None
+ *
+ *   @remarks \b Usage: @n Called from os_cbkSleep() when no task is ready.
+ *
+ */
+/*********************************************************************************/
+void os_posix_sleep(void)
+{
+	uint32_t ticks;
+	uint32_t left;
+
+	ticks = os_idle_ticks_get();
+
+	if (0 == ticks)
+	{
+		return;
+	}
+
+	left = stopTick - os_tick_count_get();
+
+	if (ticks > left)
+	{
+		ticks = left;
+	}
+
+	if (0 == ticks)
+	{
+		return;
+	}
+
+	os_task_tick(0, ticks);
+	wakeups++;
+
+	if (NULL != tickHook)
+	{
+		tickHook(os_tick_count_get());
+	}
+}
+
+/* Gets the host time in counts of 3.2 us, for OS_TASK_STATS and OS_TASK_LATENCY */
+uint16_t os_posix_stats_time_get(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return((uint16_t)(((uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec) / 3200u));
+}
+
+#endif
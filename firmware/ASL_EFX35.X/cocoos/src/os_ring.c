@@ -0,0 +1,166 @@
+/*
+ * This file is part of the cocoOS port for the ASL head array eFix firmware.
+ */
+/** @file os_ring.c Single producer, single consumer ring buffer source file */
+
+#include "cocoos.h"
+
+// Suppress "function is never called" warning for this file.
+#pragma warning disable 520
+
+static uint8_t ring_push_signal(Ring_t *ring, const void *element, uint8_t tid);
+
+/*********************************************************************************/
+/*  void ring_init( Ring_t *ring, void *buffer, uint8_t nElements, uint8_t elementSize, Evt_t event )    *//**
+ *
+ *   Initializes a ring buffer.
+ *
+ *   @param ring Ring to initialize.
+ *   @param buffer Storage for nElements elements of elementSize bytes.
+ *   @param nElements Number of elements in the buffer. Must be a power of 2, at most 128.
+ *   @param elementSize Size of one element, in bytes.
+ *   @param event Event signaled when an element is pushed, NO_EVENT if none.
+ *   @return None
+ *
+ *   @remarks \b Usage: @n Call before the producer and the consumer start. One producer
+ *   and one consumer can then use the ring at the same time, from a task or an ISR,
+ *   without disabling interrupts. Several tasks can share a side of the ring, because
+ *   tasks do not preempt each other, but an ISR and a task can not.
+ *
+ *   @code
+ *   static Ring_t rxRing;
+ *   static uint8_t rxBuffer[ 16 ];
+ *
+ *   rxEvent = event_create();
+ *   ring_init( &rxRing, rxBuffer, sizeof(rxBuffer), 1, rxEvent );
+ *   @endcode
+ *
+ */
+/*********************************************************************************/
+void ring_init(Ring_t *ring, void *buffer, uint8_t nElements, uint8_t elementSize, Evt_t event)
+{
+	os_assert(nElements != 0);
+	os_assert(nElements <= 128);
+	os_assert((nElements & (nElements - 1)) == 0);
+	os_assert(elementSize != 0);
+
+	ring->buffer = (uint8_t *)buffer;
+	ring->mask = nElements - 1;
+	ring->elementSize = elementSize;
+	ring->event = event;
+	ring->head = 0;
+	ring->tail = 0;
+}
+
+/*********************************************************************************/
+/*  uint8_t ring_push( Ring_t *ring, const void *element )    *//**
+ *
+ *   Pushes an element from a task. The ring event, if any, is signaled with the
+ *   running task as the signaling task.
+ *
+ *   @param ring Ring to push to.
+ *   @param element Element to copy into the ring.
+ *   @return 1 if the element was pushed, 0 if the ring is full.
+ *
+ */
+/*********************************************************************************/
+uint8_t ring_push(Ring_t *ring, const void *element)
+{
+	return(ring_push_signal(ring, element, running_tid));
+}
+
+/*********************************************************************************/
+/*  uint8_t ring_ISR_push( Ring_t *ring, const void *element )    *//**
+ *
+ *   Pushes an element from an ISR. The ring event, if any, is signaled like
+ *   event_ISR_signal() does.
+ *
+ *   @param ring Ring to push to.
+ *   @param element Element to copy into the ring.
+ *   @return 1 if the element was pushed, 0 if the ring is full.
+ *
+ */
+/*********************************************************************************/
+uint8_t ring_ISR_push(Ring_t *ring, const void *element)
+{
+	return(ring_push_signal(ring, element, ISR_TID));
+}
+
+/*********************************************************************************/
+/*  uint8_t ring_pop( Ring_t *ring, void *element )    *//**
+ *
+ *   Pops the oldest element.
+ *
+ *   @param ring Ring to pop from.
+ *   @param element The element is copied here.
+ *   @return 1 if an element was popped, 0 if the ring is empty.
+ *
+ */
+/*********************************************************************************/
+uint8_t ring_pop(Ring_t *ring, void *element)
+{
+	uint8_t tail;
+	uint8_t i;
+	uint8_t *src;
+	uint8_t *dst;
+
+	tail = ring->tail;
+
+	if (ring->head == tail)
+	{
+		return(0);
+	}
+
+	src = ring->buffer + (uint16_t)(tail & ring->mask) * ring->elementSize;
+	dst = (uint8_t *)element;
+
+	for (i = 0; i != ring->elementSize; ++i)
+	{
+		dst[i] = src[i];
+	}
+
+	/* Hand the slot back to the producer only after it has been read */
+	ring->tail = tail + 1;
+
+	return(1);
+}
+
+/* Gets the number of elements in the ring */
+uint8_t ring_count(const Ring_t *ring)
+{
+	return((uint8_t)(ring->head - ring->tail));
+}
+
+static uint8_t ring_push_signal(Ring_t *ring, const void *element, uint8_t tid)
+{
+	uint8_t head;
+	uint8_t i;
+	uint8_t *src;
+	uint8_t *dst;
+
+	head = ring->head;
+
+	if ((uint8_t)(head - ring->tail) > ring->mask)
+	{
+		return(0);
+	}
+
+	src = (uint8_t *)element;
+	dst = ring->buffer + (uint16_t)(head & ring->mask) * ring->elementSize;
+
+	for (i = 0; i != ring->elementSize; ++i)
+	{
+		dst[i] = src[i];
+	}
+
+	/* Publish the element to the consumer only after it has been written */
+	ring->head = head + 1;
+
+	if (NO_EVENT != ring->event)
+	{
+		os_signal_event(ring->event);
+		os_event_set_signaling_tid(ring->event, tid);
+	}
+
+	return(1);
+}
@@ -137,6 +137,7 @@ void os_sem_decrement(Sem_t sem)
 	if (semList[sem].value > 0)
 	{
 		--semList[sem].value;
+		os_trace(TRACE_SEM_TAKE, sem);
 	}
 
 #endif
@@ -145,6 +146,8 @@ void os_sem_decrement(Sem_t sem)
 void os_sem_increment(Sem_t sem)
 {
 #if (N_TOTAL_SEMAPHORES > 0)
+	os_trace(TRACE_SEM_GIVE, sem);
+
 	if (semList[sem].value < semList[sem].maxValue)
 	{
 		++semList[sem].value;
@@ -49,18 +49,33 @@ struct tcb
 	WakeReason_t wake_reason;
 	TaskState_t savedState;             ///< saves the task state when suspending
 	uint16_t internal_state;        ///< is set when calling OS_SCHEDULE
-	uint32_t time;
+	TaskTime_t time;                  ///< Ticks after the previous entry while in the timer list
 	uint8_t tid;
 	uint8_t prio;
+	uint8_t rank;                     ///< Position in priority order, bit index in the ready map
+	uint8_t timerNext;                ///< Next task in the timer list, TIMER_UNLINKED when not in it
+	uint16_t overruns;                ///< Number of periodic releases missed in task_wait_until
 	Sem_t semaphore;
+#if (N_QUEUES > 0)
 	MsgQ_t msgQ;
 	MsgQ_t waitQ;                     ///< The queue the task is waiting for (post or receive)
 	Evt_t msgChangeEvent;             ///< The change event of the message queue the task is waiting for
 	uint8_t msgResult;                ///< The result of msg_receive or msg_post
-	uint8_t waitSingleEvent;
+#endif
+	uint8_t waitSingleEvent;          ///< 1: wake on any event in eventMask, 0: wake when all are signaled
 	uint8_t clockId;
-	EventQueue_t eventQueue;
+	EventMask_t eventMask;            ///< Events the task is waiting for
+#ifdef OS_TASK_DATA
 	void *data;
+#endif
+#ifdef OS_TASK_STATS
+	TaskStats_t stats;
+#endif
+#ifdef OS_TASK_LATENCY
+	TaskLatency_t latency;
+	os_stats_time_t readyTime;        ///< When the task was made ready
+	uint8_t readyStamped;             ///< Set when readyTime is valid
+#endif
 };
 
 static void task_wait_sem_set(uint8_t tid, Sem_t sem);
@@ -68,30 +83,184 @@ static void task_suspended_set(uint8_t tid);
 static void task_waiting_time_set(uint8_t tid);
 static void task_waiting_event_set(tcb *task);
 static void task_waiting_event_timeout_set(tcb *task);
-static uint8_t os_task_wait_queue_empty(uint8_t tid);
+static EventMask_t os_task_event_mask(Evt_t eventId);
 static void task_ready_set(uint8_t tid);
 static void task_killed_set(uint8_t tid);
+static void task_state_set(tcb *task, TaskState_t state);
+static void os_task_rank_update(void);
+static uint8_t os_task_ready_rank_from(uint8_t rank);
+static void os_task_timer_insert(uint8_t tid);
+static void os_task_timer_remove(uint8_t tid);
+#ifdef OS_TASK_LATENCY
+static void os_task_latency_add(tcb *task, os_stats_time_t now);
+#endif
+
+#if (N_TASKS > 64)
+#error "The ready map supports a maximum of 64 tasks"
+#endif
+
+#define N_READY_GROUPS    ((N_TASKS + 7) / 8)
+#define TIMER_UNLINKED    0xfe
 
-static tcb task_list[N_TASKS];
 static uint8_t nTasks = 0;
 
+#ifdef OS_STATIC_TASKS
+#if (N_QUEUES > 0)
+#define OS_TCB_MSGQ_INIT    .msgQ = NO_QUEUE,
+#else
+#define OS_TCB_MSGQ_INIT
+#endif
+
+/* Task control block of an OS_TASK_TABLE entry. The ranks are set by os_task_init(). */
+#define OS_TASK_TCB(tName, tProc, tPrio, tPeriod, tQueueSize, tMsgSize, tEvents, tSems) \
+	{ \
+		.taskproc = tProc, \
+		.state = READY, \
+		.savedState = READY, \
+		.tid = tName##_TASK_ID, \
+		.prio = (tPrio), \
+		.timerNext = TIMER_UNLINKED, \
+		.clockId = 0xff, \
+		OS_TCB_MSGQ_INIT \
+	},
+
+/* A period too long for a task timeout is a negative array size */
+#define OS_TASK_PERIOD_CHECK(tName, tProc, tPrio, tPeriod, tQueueSize, tMsgSize, tEvents, tSems) \
+	typedef char tName##_TASK_PERIOD_TOO_LONG[((tPeriod) <= OS_TASK_TIME_MAX) ? 1 : -1];
+
+/* Two tasks with the same priority are duplicate case labels */
+#define OS_TASK_PRIO_CASE(tName, tProc, tPrio, tPeriod, tQueueSize, tMsgSize, tEvents, tSems) \
+	case (tPrio):
+
+static tcb task_list[N_TASKS] = { OS_TASK_TABLE(OS_TASK_TCB) };
+
+OS_TASK_TABLE(OS_TASK_PERIOD_CHECK)
+
+#if (N_QUEUES > 0)
+/* Message pools of the task queues, each rounded up to a whole Mem_t */
+#define OS_TASK_POOL_MEMS(tQueueSize, tMsgSize)    ((((uint16_t)(tQueueSize) * (tMsgSize)) + sizeof(Mem_t) - 1) / sizeof(Mem_t))
+
+#define OS_TASK_POOL_SIZE(tName, tProc, tPrio, tPeriod, tQueueSize, tMsgSize, tEvents, tSems) \
+	+ OS_TASK_POOL_MEMS(tQueueSize, tMsgSize)
+
+#define OS_TASK_QUEUE_CREATE(tName, tProc, tPrio, tPeriod, tQueueSize, tMsgSize, tEvents, tSems) \
+	if ((tQueueSize) > 0) \
+	{ \
+		task_list[tName##_TASK_ID].msgQ = os_msgQ_create((Msg_t *)pool, (tQueueSize), (tMsgSize), tName##_TASK_ID); \
+		pool += OS_TASK_POOL_MEMS(tQueueSize, tMsgSize); \
+	}
+
+static Mem_t taskPools[0 OS_TASK_TABLE(OS_TASK_POOL_SIZE)];
+#endif
+
+/* Build time check of the task priorities, never called */
+static void os_task_table_check(void)
+{
+	switch (nTasks)
+	{
+	OS_TASK_TABLE(OS_TASK_PRIO_CASE)
+	default:
+		break;
+	}
+}
+#else
+static tcb task_list[N_TASKS];
+#endif
+
+/* Ready map. Bit (rank & 7) of readyMap[rank / 8] is set while the task with that rank is
+ * READY, and bit g of readyGroups is set while readyMap[g] is non zero. Rank 0 is the highest
+ * priority task. Bits are only set from interrupt context, the scheduler (task context) is
+ * the only one clearing them, and it does so in a critical section. */
+static uint8_t readyGroups;
+static uint8_t readyMap[N_READY_GROUPS];
+static uint8_t rankToTid[N_TASKS];
+
+/* Timer list. Tasks waiting on the master clock (clockId 0) are linked through timerNext,
+ * sorted by expiry, and each one holds its time relative to the entry before it. A master
+ * clock tick then only has to look at the head of the list. The list is edited by the tick
+ * in the timer ISR and, in a critical section, by task context. */
+static uint8_t timerHead;
+
+/* Master clock tick count. Time base of the periodic releases, and used to find the task that
+ * has waited longest for a semaphore with ROUND_ROBIN. */
+static uint32_t masterClock;
+
+static const uint8_t bitMask[8] = { 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80 };
+
+/* Index of the lowest set bit in a byte */
+static const uint8_t lowestBitTable[256] =
+{
+	0, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0,
+	4, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0,
+	5, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0,
+	4, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0,
+	6, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0,
+	4, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0,
+	5, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0,
+	4, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0,
+	7, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0,
+	4, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0,
+	5, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0,
+	4, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0,
+	6, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0,
+	4, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0,
+	5, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0,
+	4, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0
+};
+
+#ifdef OS_STATIC_TASKS
+/* The task control blocks are initialized at compile time from OS_TASK_TABLE. Only the message
+ * queues are created and the tasks ranked, which also sets the ready map. */
+void os_task_init(void)
+{
+#if (N_QUEUES > 0)
+	Mem_t *pool;
+#endif
+
+	nTasks = N_TASKS;
+	timerHead = NO_TID;
+	masterClock = 0;
+
+#if (N_QUEUES > 0)
+	pool = taskPools;
+	OS_TASK_TABLE(OS_TASK_QUEUE_CREATE)
+#endif
+
+	os_task_rank_update();
+}
+#else
 void os_task_init(void)
 {
 	uint8_t i;
+#ifdef OS_TASK_LATENCY
 	uint8_t j;
+#endif
 	nTasks = 0;
 	tcb *task;
 
+	readyGroups = 0;
+	timerHead = NO_TID;
+	masterClock = 0;
+
+	for (i = 0; i < N_READY_GROUPS; ++i)
+	{
+		readyMap[i] = 0;
+	}
+
 	for (i = 0; i < N_TASKS; ++i)
 	{
+		rankToTid[i] = NO_TID;
 		task = &task_list[i];
 		task->clockId = 0xff;
 		task->internal_state = 0xff;
+#if (N_QUEUES > 0)
 		task->msgQ = 0;
 		task->waitQ = 0;
 		task->msgChangeEvent = 0;
 		task->msgResult = 0;
+#endif
 		task->prio = 0;
+		task->rank = i;
 		task->savedState = SUSPENDED;
 		task->semaphore = NO_SEM;
 		task->state = SUSPENDED;
@@ -99,16 +268,33 @@ void os_task_init(void)
 		task->taskproc = 0;
 		task->tid = NO_TID;
 		task->time = 0;
+		task->timerNext = TIMER_UNLINKED;
+		task->overruns = 0;
 		task->waitSingleEvent = 0;
+		task->eventMask = 0;
+#ifdef OS_TASK_DATA
+		task->data = 0;
+#endif
+
+#ifdef OS_TASK_STATS
+		task->stats.runTime = 0;
+		task->stats.runCount = 0;
+		task->stats.maxRunTime = 0;
+#endif
 
-		for (j = 0; j < sizeof(task->eventQueue.eventList); j++)
+#ifdef OS_TASK_LATENCY
+		for (j = 0; j < OS_LATENCY_BINS; j++)
 		{
-			task->eventQueue.eventList[j] = 0xff;
+			task->latency.bins[j] = 0;
 		}
 
-		task->data = 0;
+		task->latency.maxLatency = 0;
+		task->readyTime = 0;
+		task->readyStamped = 0;
+#endif
 	}
 }
+#endif
 
 /************************************************************** *******************/
 /*  uint8_t task_create( taskproctype taskproc, void *data, uint8_t prio, Msg_t *msgPool, uint8_t poolSize, uint16_t msgSize )    *//**
@@ -124,7 +310,8 @@ void os_task_init(void)
  *   @return Task id of the created task.
  *
  *   @remarks \b Usage: @n Should be called early in system setup, before starting the task
- *   execution. Only one task per priority level is allowed.
+ *   execution. Only one task per priority level is allowed. Not used with OS_STATIC_TASKS,
+ *   the tasks are then declared in OS_TASK_TABLE.
  *
  *   @code
  *   static uint8_t taskId;
@@ -169,6 +356,9 @@ uint8_t task_create(taskproctype taskproc, void *data, uint8_t prio, Msg_t *msgP
 	task->taskproc = taskproc;
 	task->waitSingleEvent = 0;
 	task->time = 0;
+	task->timerNext = TIMER_UNLINKED;
+	task->overruns = 0;
+#if (N_QUEUES > 0)
 	if (poolSize > 0)
 	{
 		task->msgQ = os_msgQ_create(msgPool, poolSize, msgSize, task->tid);
@@ -177,11 +367,20 @@ uint8_t task_create(taskproctype taskproc, void *data, uint8_t prio, Msg_t *msgP
 	{
 		task->msgQ = NO_QUEUE;
 	}
+#else
+	os_assert(poolSize == 0);
+#endif
 
+#ifdef OS_TASK_DATA
 	task->data = data;
+#else
+	os_assert(data == NULL);
+#endif
 	os_task_clear_wait_queue(nTasks);
 
 	nTasks++;
+	os_task_rank_update();
+
 	return(task->tid);
 }
 
@@ -191,6 +390,22 @@ TaskState_t task_state_get(uint8_t tid)
 	return(task_list[tid].state);
 }
 
+/*********************************************************************************/
+/*  uint16_t task_overruns_get( uint8_t tid )                                   *//**
+ *
+ *   Gets the number of times a periodic task has missed its release time in
+ *   task_wait_until(). The count saturates at 0xffff.
+ *
+ *   @param tid id of the task.
+ *   @return Number of overruns.
+ *
+ */
+/*********************************************************************************/
+uint16_t task_overruns_get(uint8_t tid)
+{
+	return(os_task_overruns_get(tid));
+}
+
 WakeReason_t task_wake_reason(uint8_t tid)
 {
 	os_assert(tid < nTasks);
@@ -255,6 +470,7 @@ void task_kill(uint8_t tid)
 	os_task_kill(tid);
 }
 
+#ifdef OS_TASK_DATA
 /*********************************************************************************/
 /*  void task_get_data()                                   *//**
  *
@@ -262,6 +478,8 @@ void task_kill(uint8_t tid)
  *
  *   @return pointer to task data
  *
+ *   @remarks \b Usage: @n Only available when OS_TASK_DATA is defined.
+ *
  *   @code
 
 
@@ -291,79 +509,117 @@ void*task_get_data()
 {
 	return(task_list[running_tid].data);
 }
+#endif
+
+#ifdef OS_TASK_STATS
+/*********************************************************************************/
+/*  void task_stats_get( uint8_t tid, TaskStats_t *stats )                                   *//**
+ *
+ *   Gets the run time statistics of a task. Times are in counts of the free running
+ *   stats timer of the port, see os_stats_time_get() in os_port.h.
+ *
+ *   @param tid id of the task.
+ *   @param stats the statistics are copied here.
+ *   @return None
+ *
+ *   @remarks \b Usage: @n Only available when OS_TASK_STATS is defined.
+ *
+ *   @code
+   static void statsTask(void)
+   {
+   static TaskStats_t stats;
+   task_open();
+   for (;;) {
+    task_wait( 1000 );
+    task_stats_get( eFixTaskId, &stats );
+    ...
+   }
+   task_close();
+   }
+ *   @endcode
+ *
+ */
+/*********************************************************************************/
+void task_stats_get(uint8_t tid, TaskStats_t *stats)
+{
+	os_assert(tid < nTasks);
+
+	/* Only updated by os_task_run(), in task context */
+	*stats = task_list[tid].stats;
+}
+
+#endif
+
+#ifdef OS_TASK_LATENCY
+/*********************************************************************************/
+/*  void task_latency_get( uint8_t tid, TaskLatency_t *latency )                                   *//**
+ *
+ *   Gets the wake-up latency histogram of a task, that is the time from the task being
+ *   made ready, by a timeout or an event, until it is run. Times are in counts of the
+ *   free running stats timer of the port, see os_stats_time_get() in os_port.h.
+ *
+ *   @param tid id of the task.
+ *   @param latency the histogram is copied here.
+ *   @return None
+ *
+ *   @remarks \b Usage: @n Only available when OS_TASK_LATENCY is defined. A task that
+ *   is still ready after it has run is measured from the end of that run. Latencies
+ *   longer than one period of the stats timer are not detected.
+ *
+ */
+/*********************************************************************************/
+void task_latency_get(uint8_t tid, TaskLatency_t *latency)
+{
+	os_assert(tid < nTasks);
+
+	/* Only updated by os_task_run(), in task context */
+	*latency = task_list[tid].latency;
+}
+
+#endif
 
 /* Finds the task with highest prio that are ready to run - used for prio based scheduling */
 uint8_t os_task_highest_prio_ready_task(void)
 {
-	uint16_t index;
-	tcb *task;
-	uint8_t highest_prio_task = NO_TID;
-	uint8_t highest_prio = 255;
-	TaskState_t state;
-	uint8_t prio;
+	uint8_t rank;
 
-	for (index = 0; index != nTasks; ++index)
-	{
-		task = &task_list[index];
-		prio = task->prio;
-		state = task->state;
+	rank = os_task_ready_rank_from(0);
 
-		if (READY == state)
-		{
-			if (prio < highest_prio)
-			{
-				highest_prio = prio;
-				highest_prio_task = index;
-			}
-		}
+	if (NO_TID == rank)
+	{
+		return(NO_TID);
 	}
 
-	return(highest_prio_task);
+	return(rankToTid[rank]);
 }
 
 /* Finds the next ready task - used when ROUND_ROBIN is defined */
 uint8_t os_task_next_ready_task(void)
 {
-	uint16_t index;
-	uint8_t found;
-	uint8_t nChecked;
+	uint8_t rank;
+
+	rank = NO_TID;
 
-	if (NO_TID == last_running_task)
+	if (NO_TID != last_running_task)
 	{
-		index = 0;
+		/* Continue after the task that ran last... */
+		rank = os_task_ready_rank_from(task_list[last_running_task].rank + 1);
 	}
-	else
-	{
-		index = last_running_task + 1;
-		if (index >= nTasks)
-		{
-			index = 0;
-		}
-	}
-
-	found = 0;
-	nChecked = 0;
 
-	do
+	if (NO_TID == rank)
 	{
-		if (READY == task_list[index].state)
-		{
-			last_running_task = index;
-			found = 1;
-			break;
-		}
-
-		++index;
-		if (index == nTasks)
-		{
-			index = 0;
-		}
-	} while (++nChecked != nTasks);
+		/* ...and wrap around to the beginning */
+		rank = os_task_ready_rank_from(0);
+	}
 
-	if (!found)
+	if (NO_TID == rank)
 	{
 		last_running_task = NO_TID;
 	}
+	else
+	{
+		last_running_task = rankToTid[rank];
+	}
 
 	return(last_running_task);
 }
@@ -372,7 +628,9 @@ uint8_t os_task_next_ready_task(void)
 void os_task_release_waiting_task(Sem_t sem)
 {
 #ifdef ROUND_ROBIN
-	uint32_t longestWaitTime = 0;
+	TaskTime_t longestWaitTime = 0;
+	TaskTime_t waitTime;
+	TaskTime_t now = (TaskTime_t)os_task_clock_get();
 	uint8_t lastCheckedTask = NO_TID;
 #else
 	uint8_t highestPrio = 255;
@@ -393,9 +651,10 @@ void os_task_release_waiting_task(Sem_t sem)
 #ifdef ROUND_ROBIN
 			/* Release the task that has waited longest */
 			lastCheckedTask = tid;
-			if (task->time > longestWaitTime)
+			waitTime = (TaskTime_t)(now - task->time);
+			if (waitTime > longestWaitTime)
 			{
-				longestWaitTime = task->time;
+				longestWaitTime = waitTime;
 				foundTask = tid;
 			}
 
@@ -422,7 +681,10 @@ void os_task_release_waiting_task(Sem_t sem)
 #endif
 	if (NO_TID != foundTask)
 	{
-		task_list[foundTask].state = READY;
+		/* The semaphore is handed straight to the released task */
+		os_trace(TRACE_SEM_GIVE, sem);
+		os_trace(TRACE_SEM_TAKE, sem);
+		task_ready_set(foundTask);
 	}
 }
 
@@ -455,14 +717,18 @@ void os_task_wait_sem_set(uint8_t tid, Sem_t sem)
 	os_assert(tid < nTasks);
 	task_wait_sem_set(tid, sem);
 
-	/* The time is ticked to measure waiting time */
-	task_list[tid].time = 0;
+#ifdef ROUND_ROBIN
+	/* Stamp the clock instead of ticking every waiting task, the wait time is the difference. With
+	 * 16 bit task timeouts the wait time wraps after OS_TASK_TIME_MAX ticks. */
+	task_list[tid].time = (TaskTime_t)os_task_clock_get();
+#endif
 }
 
 /* Sets the task to ready state */
 void os_task_ready_set(uint8_t tid)
 {
 	os_assert(tid < nTasks);
+	os_task_timer_remove(tid);
 	task_ready_set(tid);
 }
 
@@ -490,23 +756,34 @@ void os_task_suspend(uint8_t tid)
 			task_list[tid].savedState = state;
 		}
 
+		/* The remaining wait time is kept in the tcb and does not run while suspended */
+		os_task_timer_remove(tid);
 		task_suspended_set(tid);
 	}
 }
 
 void os_task_resume(uint8_t tid)
 {
+	TaskState_t state;
+
 	os_assert(tid < nTasks);
 
 	if (task_list[tid].state == SUSPENDED)
 	{
-		task_list[tid].state = task_list[tid].savedState;
+		state = task_list[tid].savedState;
+		task_state_set(&task_list[tid], state);
+
+		if (((WAITING_TIME == state) || (WAITING_EVENT_TIMEOUT == state)) && (0 == task_list[tid].clockId))
+		{
+			os_task_timer_insert(tid);
+		}
 	}
 }
 
 void os_task_kill(uint8_t tid)
 {
 	os_assert(tid < nTasks);
+	os_task_timer_remove(tid);
 	task_killed_set(tid);
 }
 
@@ -519,73 +796,47 @@ uint8_t os_task_prio_get(uint8_t tid)
 /* Clears the event wait queue of a task */
 void os_task_clear_wait_queue(uint8_t tid)
 {
-	uint8_t event;
-	tcb *task;
-
-	task = &task_list[tid];
-
-	task->waitSingleEvent = 0;
-	event = EVENT_QUEUE_SIZE;
-
-	do
-	{
-		--event;
-		task->eventQueue.eventList[event] = 0;
-	} while (event != 0);
-}
-
-/* Checks if a tasks event wait queue is empty or not */
-static uint8_t os_task_wait_queue_empty(uint8_t tid)
-{
-	uint8_t event;
-	uint8_t result;
-
-	result = 1;
-	event = EVENT_QUEUE_SIZE;
-
-	do
-	{
-		--event;
-		if (task_list[tid].eventQueue.eventList[event] != 0)
-		{
-			result = 0;
-		}
-	} while (event != 0);
-
-	return(result);
+	task_list[tid].waitSingleEvent = 0;
+	task_list[tid].eventMask = 0;
 }
 
 void os_task_wait_time_set(uint8_t tid, uint8_t id, uint32_t time)
 {
 	os_assert(tid < nTasks);
 	os_assert(time > 0);
+	os_assert(time <= OS_TASK_TIME_MAX);
 
+	os_task_timer_remove(tid);
 	task_list[tid].clockId = id;
-	task_list[tid].time = time;
+	task_list[tid].time = (TaskTime_t)time;
 	task_waiting_time_set(tid);
+
+	if (0 == id)
+	{
+		os_task_timer_insert(tid);
+	}
 }
 
 void os_task_wait_event(uint8_t tid, Evt_t eventId, uint8_t waitSingleEvent, uint32_t timeout)
 {
-	uint8_t eventListIndex;
-	uint8_t shift;
 	tcb *task;
 
 	os_assert(tid < nTasks);
+	os_assert(eventId < N_TOTAL_EVENTS);
+	os_assert(timeout <= OS_TASK_TIME_MAX);
 
 	task = &task_list[tid];
 
-	eventListIndex = eventId / 8;
-	shift = eventId & 0x07;
-
-	task->eventQueue.eventList[eventListIndex] |= 1 << shift;
+	task->eventMask |= os_task_event_mask(eventId);
 	task->waitSingleEvent = waitSingleEvent;
 	if (timeout != 0)
 	{
 		/* Waiting for an event with timeout - clockId = 0, master clock */
+		os_task_timer_remove(tid);
 		task->clockId = 0;
-		task->time = timeout;
+		task->time = (TaskTime_t)timeout;
 		task_waiting_event_timeout_set(task);
+		os_task_timer_insert(tid);
 	}
 	else
 	{
@@ -596,45 +847,65 @@ void os_task_wait_event(uint8_t tid, Evt_t eventId, uint8_t waitSingleEvent, uin
 void os_task_tick(uint8_t id, uint32_t tickSize)
 {
 	uint8_t index;
+	TaskState_t state;
+	tcb *task;
 
-	/* Search all tasks and decrement time for waiting tasks */
-	for (index = 0; index != nTasks; ++index)
+	if (0 == id)
 	{
-		TaskState_t state;
-		state = task_list[index].state;
-		if ((state == WAITING_TIME) || (state == WAITING_EVENT_TIMEOUT))
+		masterClock += tickSize;
+
+		/* Expire the tasks at the head of the timer list, the rest only move with the head */
+		while (NO_TID != timerHead)
 		{
-			/* Found a waiting task, is it ready? */
-			if (task_list[index].clockId == id)
+			task = &task_list[timerHead];
+
+			if (task->time > tickSize)
 			{
-				if (task_list[index].time <= tickSize)
-				{
-					task_list[index].time = 0;
-					if (state == WAITING_EVENT_TIMEOUT)
-					{
-						os_task_clear_wait_queue(index);
-						task_list[index].wake_reason = WAKE_REASON_OS_TIMEOUT;
-					}
+				task->time -= (TaskTime_t)tickSize;
+				break;
+			}
 
-					task_ready_set(index);
-				}
-				else
-				{
-					task_list[index].time -= tickSize;
-				}
+			tickSize -= task->time;
+			task->time = 0;
+			timerHead = task->timerNext;
+			task->timerNext = TIMER_UNLINKED;
+
+			if (task->state == WAITING_EVENT_TIMEOUT)
+			{
+				os_task_clear_wait_queue(task->tid);
+				task->wake_reason = WAKE_REASON_OS_TIMEOUT;
 			}
+
+			task_ready_set(task->tid);
 		}
-		else if (state ==  WAITING_SEM)
-		{
-			task_list[index].time++;
-		}
 
-		/* If the task has a message queue, decrement the delayed message timers */
-		if (id == 0)
+		/* Signal the queues holding messages that fall due */
+		os_msgQ_tick_all(masterClock);
+		return;
+	}
+
+	/* Sub clocks are ticked by the application and are not in the timer list */
+	for (index = 0; index != nTasks; ++index)
+	{
+		task = &task_list[index];
+		state = task->state;
+
+		if (((state == WAITING_TIME) || (state == WAITING_EVENT_TIMEOUT)) && (task->clockId == id))
 		{
-			if (task_list[index].msgQ != NO_QUEUE)
+			if (task->time <= tickSize)
 			{
-				os_msgQ_tick(task_list[index].msgQ);
+				task->time = 0;
+				if (state == WAITING_EVENT_TIMEOUT)
+				{
+					os_task_clear_wait_queue(index);
+					task->wake_reason = WAKE_REASON_OS_TIMEOUT;
+				}
+
+				task_ready_set(index);
+			}
+			else
+			{
+				task->time -= (TaskTime_t)tickSize;
 			}
 		}
 	}
@@ -643,38 +914,32 @@ void os_task_tick(uint8_t id, uint32_t tickSize)
 void os_task_signal_event(Evt_t eventId)
 {
 	uint8_t index;
+	EventMask_t mask;
+	TaskState_t state;
+	tcb *task;
 
-	uint8_t eventListIndex;
-	uint8_t shift;
-
-	eventListIndex = eventId / 8;
-	shift = eventId & 0x07;
+	mask = os_task_event_mask(eventId);
 
 	for (index = 0; index != nTasks; index++)
 	{
-		uint8_t taskWaitingForEvent;
-		uint8_t taskWaitStateOK;
-		TaskState_t state;
-
-		state = task_list[index].state;
-		taskWaitStateOK = 0;
-
-		if ((state == WAITING_EVENT) || (state == WAITING_EVENT_TIMEOUT))
-		{
-			taskWaitStateOK = 1;
-		}
-
-		taskWaitingForEvent = task_list[index].eventQueue.eventList[eventListIndex] & (1 << shift);
+		task = &task_list[index];
 
-		if (taskWaitingForEvent  &&  taskWaitStateOK)
+		if (0 != (task->eventMask & mask))
 		{
-			task_list[index].eventQueue.eventList[eventListIndex] &= ~(1 << shift);
+			state = task->state;
 
-			if (task_list[index].waitSingleEvent || os_task_wait_queue_empty(index))
+			if ((state == WAITING_EVENT) || (state == WAITING_EVENT_TIMEOUT))
 			{
-				task_list[index].wake_reason = WAKE_REASON_OS_EVENT;
-				os_task_clear_wait_queue(index);
-				task_ready_set(index);
+				task->eventMask &= (EventMask_t)~mask;
+
+				/* Any of the events, or the last one of all the events */
+				if (task->waitSingleEvent || (0 == task->eventMask))
+				{
+					task->wake_reason = WAKE_REASON_OS_EVENT;
+					os_task_clear_wait_queue(index);
+					os_task_timer_remove(index);
+					task_ready_set(index);
+				}
 			}
 		}
 	}
@@ -683,8 +948,72 @@ void os_task_signal_event(Evt_t eventId)
 /* Runs the next task ready for execution. Assumes running_tid has been assigned */
 void os_task_run(void)
 {
+#if defined(OS_TASK_STATS) || defined(OS_TASK_LATENCY)
+	tcb *task;
+	os_stats_time_t start;
+#endif
+#ifdef OS_TASK_STATS
+	os_stats_time_t runTime;
+#endif
+#ifdef OS_TASK_LATENCY
+	os_irq_state_t irq;
+#endif
+#ifdef OS_TRACE
+	uint8_t tid;
+#endif
+
 	os_assert(running_tid < nTasks);
+
+#ifdef OS_TRACE
+	/* running_tid is cleared when the task yields */
+	tid = running_tid;
+	os_trace_record(TRACE_TASK_DISPATCH, tid);
+#endif
+
+#if defined(OS_TASK_STATS) || defined(OS_TASK_LATENCY)
+	task = &task_list[running_tid];
+
+	start = os_stats_time_get();
+
+#ifdef OS_TASK_LATENCY
+	os_task_latency_add(task, start);
+#endif
+
+	task->taskproc();
+
+#ifdef OS_TASK_STATS
+	runTime = os_stats_time_get() - start;
+
+	task->stats.runTime += runTime;
+	task->stats.runCount++;
+
+	if (runTime > task->stats.maxRunTime)
+	{
+		task->stats.maxRunTime = runTime;
+	}
+
+#endif
+
+#ifdef OS_TASK_LATENCY
+	/* A task that did not wait is ready again from now. If it waited and has already been
+	 * made ready again by an ISR, it is stamped already. */
+	os_critical_enter(irq);
+	if ((READY == task->state) && (0 == task->readyStamped))
+	{
+		task->readyTime = os_stats_time_get();
+		task->readyStamped = 1;
+	}
+
+	os_critical_exit(irq);
+#endif
+
+#else
 	task_list[running_tid].taskproc();
+#endif
+
+#ifdef OS_TRACE
+	os_trace_record(TRACE_TASK_YIELD, tid);
+#endif
 }
 
 uint16_t os_task_internal_state_get(uint8_t tid)
@@ -697,79 +1026,437 @@ void os_task_internal_state_set(uint8_t tid, uint16_t state)
 	task_list[tid].internal_state = state;
 }
 
+/* The message queue fields are only in the tcb when N_QUEUES > 0 */
 MsgQ_t os_task_msgQ_get(uint8_t tid)
 {
+#if (N_QUEUES > 0)
 	return(task_list[tid].msgQ);
+#else
+	return(NO_QUEUE);
+#endif
 }
 
 void os_task_set_wait_queue(uint8_t tid, MsgQ_t queue)
 {
+#if (N_QUEUES > 0)
 	task_list[tid].waitQ = queue;
+#endif
 }
 
 MsgQ_t os_task_get_wait_queue(uint8_t tid)
 {
+#if (N_QUEUES > 0)
 	return(task_list[tid].waitQ);
+#else
+	return(NO_QUEUE);
+#endif
 }
 
 void os_task_set_change_event(uint8_t tid, Evt_t event)
 {
+#if (N_QUEUES > 0)
 	task_list[tid].msgChangeEvent = event;
+#endif
 }
 
 Evt_t os_task_get_change_event(uint8_t tid)
 {
+#if (N_QUEUES > 0)
 	return(task_list[tid].msgChangeEvent);
+#else
+	return(NO_EVENT);
+#endif
 }
 
 void os_task_set_msg_result(uint8_t tid, uint8_t result)
 {
+#if (N_QUEUES > 0)
 	task_list[tid].msgResult = result;
+#endif
 }
 
 uint8_t os_task_get_msg_result(uint8_t tid)
 {
+#if (N_QUEUES > 0)
 	return(task_list[tid].msgResult);
+#else
+	return(0);
+#endif
 }
 
-/* Use this to differentiate between event timeout or not */
+/* Use this to differentiate between event timeout or not. On an event, the time left of the timeout is returned. */
 uint32_t os_task_timeout_get(uint8_t tid)
 {
 	return(task_list[tid].time);
 }
 
+/* Gets the master clock tick count */
+uint32_t os_task_clock_get(void)
+{
+	uint32_t now;
+	os_irq_state_t irq;
+
+	/* Read in a critical section, the tick ISR could change it half way */
+	os_critical_enter(irq);
+	now = masterClock;
+	os_critical_exit(irq);
+
+	return(now);
+}
+
+/* Sets the task to wait for the next periodic release, one period after *release. The release time
+ * is updated. If the release time has already passed the overrun is counted, the task stays ready,
+ * and the periods start over from now. */
+void os_task_wait_until_set(uint8_t tid, uint32_t *release, uint32_t period)
+{
+	uint32_t next;
+	os_irq_state_t irq;
+
+	os_assert(tid < nTasks);
+	os_assert(period > 0);
+	os_assert(period <= OS_TASK_TIME_MAX);
+
+	/* No tick may come between reading the clock and putting the task in the timer list */
+	os_critical_enter(irq);
+
+	next = *release + period;
+
+	if ((int32_t)(next - masterClock) > 0)
+	{
+		*release = next;
+		os_task_wait_time_set(tid, 0, next - masterClock);
+	}
+	else
+	{
+		*release = masterClock;
+
+		if (task_list[tid].overruns != 0xffff)
+		{
+			task_list[tid].overruns++;
+		}
+	}
+
+	os_critical_exit(irq);
+}
+
+/* Gets the number of periodic releases the task has missed */
+uint16_t os_task_overruns_get(uint8_t tid)
+{
+	os_assert(tid < nTasks);
+	return(task_list[tid].overruns);
+}
+
+/* Ticks until the first task in the timer list times out, 0 if no task is waiting on the master clock */
+uint32_t os_task_next_timeout_get(void)
+{
+	if (NO_TID == timerHead)
+	{
+		return(0);
+	}
+
+	return(task_list[timerHead].time);
+}
+
 static void task_wait_sem_set(uint8_t tid, Sem_t sem)
 {
-	task_list[tid].state = WAITING_SEM;
 	task_list[tid].semaphore = sem;
+	task_state_set(&task_list[tid], WAITING_SEM);
 }
 
 static void task_ready_set(uint8_t tid)
 {
-	task_list[tid].state = READY;
+#ifdef OS_TASK_LATENCY
+	if (READY != task_list[tid].state)
+	{
+		task_list[tid].readyTime = os_stats_time_get();
+		task_list[tid].readyStamped = 1;
+	}
+
+#endif
+	task_state_set(&task_list[tid], READY);
 }
 
 static void task_suspended_set(uint8_t tid)
 {
-	task_list[tid].state = SUSPENDED;
+	task_state_set(&task_list[tid], SUSPENDED);
 }
 
 static void task_waiting_time_set(uint8_t tid)
 {
-	task_list[tid].state = WAITING_TIME;
+	task_state_set(&task_list[tid], WAITING_TIME);
 }
 
 static void task_waiting_event_set(tcb *task)
 {
-	task->state = WAITING_EVENT;
+	task_state_set(task, WAITING_EVENT);
 }
 
 static void task_waiting_event_timeout_set(tcb *task)
 {
-	task->state = WAITING_EVENT_TIMEOUT;
+	task_state_set(task, WAITING_EVENT_TIMEOUT);
 }
 
 static void task_killed_set(uint8_t tid)
 {
-	task_list[tid].state = KILLED;
+	task_state_set(&task_list[tid], KILLED);
+}
+
+/* Wait mask bit of an event. Built a byte at a time, to avoid a variable shift of a wide mask. */
+static EventMask_t os_task_event_mask(Evt_t eventId)
+{
+	union
+	{
+		EventMask_t mask;
+		uint8_t bytes[sizeof(EventMask_t)];
+	} bit;
+
+	bit.mask = 0;
+	bit.bytes[eventId >> 3] = bitMask[eventId & 0x07];
+
+	return(bit.mask);
+}
+
+/* All task state changes go through here to keep the ready map in sync with the task states */
+static void task_state_set(tcb *task, TaskState_t state)
+{
+	uint8_t group;
+	uint8_t mask;
+	os_irq_state_t irq;
+
+	group = task->rank >> 3;
+	mask = bitMask[task->rank & 0x07];
+
+	os_critical_enter(irq);
+
+	task->state = state;
+
+	if (READY == state)
+	{
+		readyMap[group] |= mask;
+		readyGroups |= bitMask[group];
+	}
+	else
+	{
+		readyMap[group] &= (uint8_t)~mask;
+		if (0 == readyMap[group])
+		{
+			readyGroups &= (uint8_t)~bitMask[group];
+		}
+	}
+
+	os_critical_exit(irq);
+}
+
+/* Returns the lowest ready rank that is >= rank, or NO_TID if there is none */
+static uint8_t os_task_ready_rank_from(uint8_t rank)
+{
+	uint8_t group;
+	uint8_t bits;
+	uint8_t groups;
+
+	group = rank >> 3;
+
+	if (group >= N_READY_GROUPS)
+	{
+		return(NO_TID);
+	}
+
+	/* Ready tasks in the same group, at or below the start rank */
+	bits = readyMap[group] & (uint8_t)(0xff << (rank & 0x07));
+
+	if (0 != bits)
+	{
+		return((uint8_t)(group << 3) + lowestBitTable[bits]);
+	}
+
+	/* Any group after the start group with a ready task */
+	groups = readyGroups & (uint8_t)(0xfe << group);
+
+	if (0 == groups)
+	{
+		return(NO_TID);
+	}
+
+	group = lowestBitTable[groups];
+
+	return((uint8_t)(group << 3) + lowestBitTable[readyMap[group]]);
+}
+
+/* Sorts the created tasks by priority and rebuilds the ready map. Called when tasks are created. */
+static void os_task_rank_update(void)
+{
+	uint8_t i;
+	uint8_t j;
+	uint8_t rank;
+	TaskState_t state;
+
+	for (i = 0; i != nTasks; ++i)
+	{
+		rank = 0;
+
+		for (j = 0; j != nTasks; ++j)
+		{
+			if (task_list[j].prio < task_list[i].prio)
+			{
+				++rank;
+			}
+		}
+
+		task_list[i].rank = rank;
+		rankToTid[rank] = i;
+	}
+
+	readyGroups = 0;
+
+	for (i = 0; i < N_READY_GROUPS; ++i)
+	{
+		readyMap[i] = 0;
+	}
+
+	for (i = 0; i != nTasks; ++i)
+	{
+		state = task_list[i].state;
+		task_state_set(&task_list[i], state);
+	}
+}
+
+/* Puts a task waiting on the master clock in the timer list. task->time holds the wait time in
+ * ticks and is converted to the time relative to the entry before it. Tasks with the same expiry
+ * time are kept in the order they were inserted. */
+static void os_task_timer_insert(uint8_t tid)
+{
+	uint8_t prev;
+	uint8_t next;
+	TaskTime_t time;
+	tcb *task;
+	os_irq_state_t irq;
+
+	task = &task_list[tid];
+
+	os_critical_enter(irq);
+
+	time = task->time;
+	prev = NO_TID;
+	next = timerHead;
+
+	while ((NO_TID != next) && (task_list[next].time <= time))
+	{
+		time -= task_list[next].time;
+		prev = next;
+		next = task_list[next].timerNext;
+	}
+
+	if (NO_TID != next)
+	{
+		task_list[next].time -= time;
+	}
+
+	task->time = time;
+	task->timerNext = next;
+
+	if (NO_TID == prev)
+	{
+		timerHead = tid;
+	}
+	else
+	{
+		task_list[prev].timerNext = tid;
+	}
+
+	os_critical_exit(irq);
+}
+
+/* Takes a task out of the timer list, if it is in it. task->time is set to the remaining wait time. */
+static void os_task_timer_remove(uint8_t tid)
+{
+	uint8_t prev;
+	uint8_t next;
+	TaskTime_t time;
+	tcb *task;
+	os_irq_state_t irq;
+
+	task = &task_list[tid];
+
+	os_critical_enter(irq);
+
+	if (TIMER_UNLINKED != task->timerNext)
+	{
+		time = 0;
+		prev = NO_TID;
+		next = timerHead;
+
+		while (next != tid)
+		{
+			time += task_list[next].time;
+			prev = next;
+			next = task_list[next].timerNext;
+		}
+
+		next = task->timerNext;
+
+		if (NO_TID != next)
+		{
+			task_list[next].time += task->time;
+		}
+
+		if (NO_TID == prev)
+		{
+			timerHead = next;
+		}
+		else
+		{
+			task_list[prev].timerNext = next;
+		}
+
+		task->time += time;
+		task->timerNext = TIMER_UNLINKED;
+	}
+
+	os_critical_exit(irq);
+}
+
+#ifdef OS_TASK_LATENCY
+/* Counts the time since the task was made ready in its log2 latency bin. Called when the task is run.
+ * The task is ready, so ISRs do not touch its ready stamp here. */
+static void os_task_latency_add(tcb *task, os_stats_time_t now)
+{
+	os_stats_time_t latency;
+	uint8_t bin;
+
+	if (0 != task->readyStamped)
+	{
+		task->readyStamped = 0;
+		latency = now - task->readyTime;
+
+		if (latency > task->latency.maxLatency)
+		{
+			task->latency.maxLatency = latency;
+		}
+
+		/* The bin is the bit length of the latency */
+		bin = 0;
+
+		if (0 != (latency & 0xff00))
+		{
+			bin = 8;
+			latency >>= 8;
+		}
+
+		while (0 != latency)
+		{
+			++bin;
+			latency >>= 1;
+		}
+
+		if (bin >= OS_LATENCY_BINS)
+		{
+			bin = OS_LATENCY_BINS - 1;
+		}
+
+		if (task->latency.bins[bin] != 0xffff)
+		{
+			task->latency.bins[bin]++;
+		}
+	}
 }
+#endif
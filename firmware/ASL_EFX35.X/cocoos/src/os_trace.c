@@ -0,0 +1,131 @@
+/*
+ * This file is part of the cocoOS port for the ASL head array eFix firmware.
+ */
+/** @file os_trace.c Kernel trace source file */
+
+#include "cocoos.h"
+
+// Suppress "function is never called" warning for this file.
+#pragma warning disable 520
+
+#ifdef OS_TRACE
+
+/* Records are written by tasks and ISRs and read by one task. When the buffer is full new
+ * records are dropped and counted, so the records that were read are always contiguous. */
+static TraceRecord_t traceBuffer[OS_TRACE_SIZE];
+static uint8_t traceHead;
+static uint8_t traceTail;
+static uint8_t traceLost;
+
+#endif
+
+/* Empties the trace buffer */
+void os_trace_init(void)
+{
+#ifdef OS_TRACE
+	traceHead = 0;
+	traceTail = 0;
+	traceLost = 0;
+#endif
+}
+
+/*********************************************************************************/
+/*  void os_trace_record( uint8_t type, uint8_t id )    *//**
+ *
+ *   Adds a record to the trace buffer, stamped with the port timer.
+ *
+ *   @param type Kind of record, TRACE_TASK_DISPATCH etc.
+ *   @param id Task, event, semaphore or queue id.
+ *   @return None
+ *
+ *   @remarks \b Usage: @n Called by the kernel through os_trace(), from a task or an ISR.
+ *
+ */
+/*********************************************************************************/
+void os_trace_record(uint8_t type, uint8_t id)
+{
+#ifdef OS_TRACE
+	os_irq_state_t irq;
+	TraceRecord_t *record;
+
+	os_critical_enter(irq);
+
+	if ((uint8_t)(traceHead - traceTail) < OS_TRACE_SIZE)
+	{
+		record = &traceBuffer[traceHead & (OS_TRACE_SIZE - 1)];
+		record->type = type;
+		record->id = id;
+		record->time = os_stats_time_get();
+		traceHead++;
+	}
+	else if (traceLost != 0xff)
+	{
+		traceLost++;
+	}
+
+	os_critical_exit(irq);
+#endif
+}
+
+/*********************************************************************************/
+/*  uint8_t trace_read( TraceRecord_t *record )    *//**
+ *
+ *   Reads the oldest record from the trace buffer.
+ *
+ *   @param record The record is copied here.
+ *   @return 1 if a record was read, 0 if the buffer is empty.
+ *
+ *   @remarks \b Usage: @n Called from the task that drains the trace to the host.
+ *
+ *   @code
+ *   TraceRecord_t record;
+ *
+ *   while ( trace_read( &record ) ) {
+ *     send( &record, sizeof(record) );
+ *   }
+ *   @endcode
+ *
+ */
+/*********************************************************************************/
+uint8_t trace_read(TraceRecord_t *record)
+{
+#ifdef OS_TRACE
+	os_irq_state_t irq;
+	uint8_t result;
+
+	result = 0;
+
+	os_critical_enter(irq);
+
+	if (traceHead != traceTail)
+	{
+		*record = traceBuffer[traceTail & (OS_TRACE_SIZE - 1)];
+		traceTail++;
+		result = 1;
+	}
+
+	os_critical_exit(irq);
+
+	return(result);
+#else
+	return(0);
+#endif
+}
+
+/* Gets the number of records dropped since the last call, saturating at 255 */
+uint8_t trace_lost_get(void)
+{
+#ifdef OS_TRACE
+	os_irq_state_t irq;
+	uint8_t lost;
+
+	os_critical_enter(irq);
+	lost = traceLost;
+	traceLost = 0;
+	os_critical_exit(irq);
+
+	return(lost);
+#else
+	return(0);
+#endif
+}
@@ -0,0 +1,116 @@
+/*
+ * This file is part of the cocoOS port for the ASL head array eFix firmware.
+ */
+/** @file sim_main.c One hour simulation of a periodic task and a periodic message on the POSIX port */
+
+#include "cocoos.h"
+#include "test_check.h"
+
+#define SIM_TICKS			(60UL * 60 * 1000)
+#define TASK_PERIOD			20
+#define MSG_PERIOD			250
+
+typedef struct
+{
+	Msg_t super;
+	uint8_t value;
+} SimMsg_t;
+
+static SimMsg_t g_RxQueue[4];
+static uint8_t g_RxTaskID;
+
+static uint32_t g_Releases;
+static uint32_t g_LateMax;
+static uint32_t g_Received;
+static uint32_t g_Hooks;
+
+/* Runs every TASK_PERIOD ticks and records how late each release was */
+static void PeriodicTask(void)
+{
+	static uint32_t release;
+	uint32_t late;
+
+	task_open();
+
+	release = os_tick_count_get();
+
+	for (;;)
+	{
+		late = os_tick_count_get() - release;
+
+		if (late > g_LateMax)
+		{
+			g_LateMax = late;
+		}
+
+		g_Releases++;
+		task_wait_until(release, TASK_PERIOD);
+	}
+
+	task_close();
+}
+
+static void ReceiveTask(void)
+{
+	static SimMsg_t msg;
+
+	task_open();
+
+	for (;;)
+	{
+		msg_receive(g_RxTaskID, &msg);
+		g_Received++;
+	}
+
+	task_close();
+}
+
+/* Posts one message to the receive task every MSG_PERIOD ticks */
+static void SendTask(void)
+{
+	static SimMsg_t msg;
+
+	task_open();
+
+	msg.super.signal = 1;
+	msg_post_every(g_RxTaskID, msg, MSG_PERIOD);
+
+	for (;;)
+	{
+		task_wait(60000);
+	}
+
+	task_close();
+}
+
+static void TickHook(uint32_t now)
+{
+	(void)now;
+	g_Hooks++;
+}
+
+int main(void)
+{
+	os_init();
+
+	task_create(PeriodicTask, NULL, 1, NULL, 0, 0);
+	g_RxTaskID = task_create(ReceiveTask, NULL, 2, (Msg_t *)g_RxQueue, 4, sizeof(SimMsg_t));
+	task_create(SendTask, NULL, 3, NULL, 0, 0);
+
+	os_posix_tick_hook_set(TickHook);
+	os_posix_run_for(SIM_TICKS);
+
+	printf("ticks %lu, releases %lu, latest %lu, messages %lu, wakeups %lu\n",
+		(unsigned long)os_tick_count_get(), (unsigned long)g_Releases, (unsigned long)g_LateMax,
+		(unsigned long)g_Received, (unsigned long)os_posix_wakeups_get());
+
+	CHECK_EQ(os_tick_count_get(), SIM_TICKS);
+	CHECK(g_Releases >= SIM_TICKS / TASK_PERIOD);
+	CHECK_EQ(g_LateMax, 0);
+	CHECK(g_Received >= (SIM_TICKS / MSG_PERIOD) - 1);
+	CHECK_EQ(g_Hooks, os_posix_wakeups_get());
+	/* Tickless: the clock only advances to the next release or deadline, never one tick at a time */
+	CHECK(os_posix_wakeups_get() < SIM_TICKS / 10);
+
+	return(TEST_RESULT("sim_main"));
+}
@@ -0,0 +1,47 @@
+/*
+ * This file is part of the cocoOS port for the ASL head array eFix firmware.
+ */
+/** @file rtos_task_priorities.h Task table of the OS_STATIC_TASKS host test, see test_static.c */
+
+#ifndef RTOS_TASK_PRIORITIES_H_
+#define RTOS_TASK_PRIORITIES_H_
+
+#define HI_TASK_PRIO		(1)
+#define RX_TASK_PRIO		(3)
+
+// Tables that must not build, see the Makefile
+#if defined(TEST_DUPLICATE_PRIO)
+#define LO_TASK_PRIO		RX_TASK_PRIO
+#else
+#define LO_TASK_PRIO		(7)
+#endif
+
+#define HI_TASK_PERIOD		(20)
+
+#if defined(TEST_PERIOD_TOO_LONG)
+#define LO_TASK_PERIOD		(70000)
+#else
+#define LO_TASK_PERIOD		(50)
+#endif
+
+#define RX_QUEUE_SIZE		(4)
+
+// The message size must be known in os_task.c, where Msg_t is not yet declared when this file
+// is included. The message starts with the fields of Msg_t, test_static.c checks the layout.
+typedef struct
+{
+	uint8_t signal;
+	uint8_t reserved;
+	uint8_t pad0;
+	uint8_t pad1;
+	uint32_t delay;
+	uint32_t reload;
+	uint8_t value;
+} TestMsg_t;
+
+#define OS_TASK_TABLE(X) \
+    X(HI, HiTask, HI_TASK_PRIO, HI_TASK_PERIOD, 0, 0, 0, 0) \
+    X(RX, RxTask, RX_TASK_PRIO, 0, RX_QUEUE_SIZE, sizeof(TestMsg_t), 0, 0) \
+    X(LO, LoTask, LO_TASK_PRIO, LO_TASK_PERIOD, 0, 0, 0, 0)
+
+#endif
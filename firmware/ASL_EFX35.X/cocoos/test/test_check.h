@@ -0,0 +1,21 @@
+/*
+ * This file is part of the cocoOS port for the ASL head array eFix firmware.
+ */
+/** @file test_check.h Checks shared by the host tests of the kernel */
+
+#ifndef TEST_CHECK_H__
+#define TEST_CHECK_H__
+
+#include <stdio.h>
+
+/* Number of failed checks, main() returns non zero if there was any */
+static unsigned int testFailures;
+
+#define CHECK(cond)		do { if (!(cond)) { testFailures++; printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); } } while (0)
+
+#define CHECK_EQ(a, b)	do { unsigned long a_ = (unsigned long)(a); unsigned long b_ = (unsigned long)(b); \
+							if (a_ != b_) { testFailures++; printf("%s:%d: check failed: %s == %s (%lu != %lu)\n", __FILE__, __LINE__, #a, #b, a_, b_); } } while (0)
+
+#define TEST_RESULT(name)	(printf("%s: %s\n", (name), (0 == testFailures) ? "pass" : "FAIL"), (0 == testFailures) ? 0 : 1)
+
+#endif
@@ -0,0 +1,243 @@
+/*
+ * This file is part of the cocoOS port for the ASL head array eFix firmware.
+ */
+/** @file test_event.c Host test of the event wait masks */
+
+#include <stdlib.h>
+#include "cocoos.h"
+#include "test_check.h"
+
+#define RANDOM_RUNS			500
+#define RANDOM_STEPS		500
+#define MAX_TIMEOUT			5
+
+typedef enum
+{
+	MODEL_READY,
+	MODEL_WAIT_ANY,
+	MODEL_WAIT_ALL
+} ModelWait_t;
+
+/* What a task waits for, kept apart from the kernel by the test */
+typedef struct
+{
+	ModelWait_t wait;
+	uint32_t events;
+	uint32_t timeout;
+} ModelTask_t;
+
+static ModelTask_t g_Model[N_TASKS];
+
+static void IdleTask(void)
+{
+}
+
+/* Starts a wait for one event, any of a set or all of a set, with or without a timeout */
+static void StartRandomWait(uint8_t tid)
+{
+	uint8_t waitSingle;
+	uint8_t count;
+	uint32_t timeout;
+	Evt_t ev;
+
+	waitSingle = (uint8_t)(rand() % 2);
+	count = (uint8_t)(1 + rand() % 4);
+	timeout = (rand() % 2) ? (uint32_t)(1 + rand() % MAX_TIMEOUT) : 0;
+
+	os_task_clear_wait_queue(tid);
+	g_Model[tid].wait = waitSingle ? MODEL_WAIT_ANY : MODEL_WAIT_ALL;
+	g_Model[tid].events = 0;
+	g_Model[tid].timeout = timeout;
+
+	while (count-- != 0)
+	{
+		ev = (Evt_t)(rand() % N_EVENTS);
+		os_task_wait_event(tid, ev, waitSingle, timeout);
+		g_Model[tid].events |= 1UL << ev;
+	}
+}
+
+/* The wake rules the kernel replaced: drop the event from the list, wake on any or on the last */
+static void ModelSignal(Evt_t ev)
+{
+	uint8_t tid;
+
+	for (tid = 0; tid < N_TASKS; tid++)
+	{
+		if ((MODEL_READY != g_Model[tid].wait) && (0 != (g_Model[tid].events & (1UL << ev))))
+		{
+			g_Model[tid].events &= ~(1UL << ev);
+
+			if ((MODEL_WAIT_ANY == g_Model[tid].wait) || (0 == g_Model[tid].events))
+			{
+				g_Model[tid].wait = MODEL_READY;
+			}
+		}
+	}
+}
+
+static void ModelTick(void)
+{
+	uint8_t tid;
+
+	for (tid = 0; tid < N_TASKS; tid++)
+	{
+		if ((MODEL_READY != g_Model[tid].wait) && (0 != g_Model[tid].timeout))
+		{
+			if (0 == --g_Model[tid].timeout)
+			{
+				g_Model[tid].wait = MODEL_READY;
+			}
+		}
+	}
+}
+
+static void CheckModel(void)
+{
+	uint8_t tid;
+	TaskState_t expected;
+
+	for (tid = 0; tid < N_TASKS; tid++)
+	{
+		if (MODEL_READY == g_Model[tid].wait)
+		{
+			expected = READY;
+		}
+		else if (0 != g_Model[tid].timeout)
+		{
+			expected = WAITING_EVENT_TIMEOUT;
+		}
+		else
+		{
+			expected = WAITING_EVENT;
+		}
+
+		CHECK_EQ(task_state_get(tid), expected);
+	}
+}
+
+static void TestRandomWaits(void)
+{
+	int run;
+	int step;
+	uint8_t tid;
+	Evt_t ev;
+
+	for (run = 0; run < RANDOM_RUNS; run++)
+	{
+		os_init();
+
+		for (tid = 0; tid < N_TASKS; tid++)
+		{
+			task_create(IdleTask, NULL, (uint8_t)(tid + 1), NULL, 0, 0);
+			g_Model[tid].wait = MODEL_READY;
+		}
+
+		for (ev = 0; ev < N_EVENTS; ev++)
+		{
+			event_create();
+		}
+
+		for (step = 0; step < RANDOM_STEPS; step++)
+		{
+			switch (rand() % 3)
+			{
+				case 0:
+					tid = (uint8_t)(rand() % N_TASKS);
+
+					if (MODEL_READY == g_Model[tid].wait)
+					{
+						StartRandomWait(tid);
+					}
+					break;
+				case 1:
+					ev = (Evt_t)(rand() % N_EVENTS);
+					os_task_signal_event(ev);
+					ModelSignal(ev);
+					break;
+				default:
+					os_task_tick(0, 1);
+					ModelTick();
+					break;
+			}
+
+			CheckModel();
+		}
+	}
+}
+
+/* An "ISR" sets a flag and signals, the task waits unless the flag is set */
+static volatile uint8_t g_EdgePending;
+static uint32_t g_EdgeTick;
+static uint32_t g_EdgesHandled;
+static Evt_t g_EdgeEvent;
+
+static void EdgeIsr(void)
+{
+	if (!g_EdgePending)
+	{
+		g_EdgeTick = os_tick_count_get();
+		g_EdgePending = 1;
+	}
+
+	event_ISR_signal(g_EdgeEvent);
+}
+
+static void EdgeTickHook(uint32_t now)
+{
+	(void)now;
+
+	if (0 == rand() % 3)
+	{
+		EdgeIsr();
+	}
+}
+
+static void EdgeTask(void)
+{
+	task_open();
+
+	for (;;)
+	{
+		if (g_EdgePending)
+		{
+			/* Handled on the tick of the edge, never at the timeout */
+			CHECK_EQ(os_tick_count_get(), g_EdgeTick);
+			g_EdgePending = 0;
+			g_EdgesHandled++;
+		}
+
+		/* An edge between the check above and the wait */
+		if (rand() % 2)
+		{
+			EdgeIsr();
+		}
+
+		event_wait_timeout_unless(g_EdgeEvent, 1000, g_EdgePending);
+	}
+
+	task_close();
+}
+
+static void TestWaitUnless(void)
+{
+	os_init();
+	g_EdgeEvent = event_create();
+	task_create(EdgeTask, NULL, 1, NULL, 0, 0);
+
+	os_posix_tick_hook_set(EdgeTickHook);
+	os_posix_run_for(100000);
+	os_posix_tick_hook_set(NULL);
+
+	CHECK(g_EdgesHandled > 100);
+}
+
+int main(void)
+{
+	srand(1);
+
+	TestRandomWaits();
+	TestWaitUnless();
+
+	return(TEST_RESULT("test_event"));
+}
@@ -0,0 +1,141 @@
+/*
+ * This file is part of the cocoOS port for the ASL head array eFix firmware.
+ */
+/** @file test_msgq.c Host test of the message queue deadlines */
+
+#include "cocoos.h"
+#include "test_check.h"
+
+#define RUN_TICKS			400
+#define MAX_RECEIVED		16
+
+#define SIG_NOW				1
+#define SIG_DELAYED			2
+#define SIG_PERIODIC		3
+
+typedef struct
+{
+	Msg_t super;
+} TestMsg_t;
+
+typedef struct
+{
+	uint32_t tick;
+	uint8_t signal;
+} Received_t;
+
+static TestMsg_t g_RxQueue[4];
+static uint8_t g_RxTaskID;
+
+static Received_t g_Received[MAX_RECEIVED];
+static uint8_t g_nReceived;
+
+/* Receive ticks of the three messages posted at tick 0 */
+static const Received_t g_Expected[] =
+{
+	{ 0, SIG_NOW },
+	{ 30, SIG_DELAYED },
+	{ 50, SIG_PERIODIC },
+	{ 100, SIG_PERIODIC },
+	{ 150, SIG_PERIODIC },
+	{ 200, SIG_PERIODIC },
+	{ 250, SIG_PERIODIC },
+	{ 300, SIG_PERIODIC },
+	{ 350, SIG_PERIODIC }
+};
+
+#define N_EXPECTED			(sizeof(g_Expected) / sizeof(g_Expected[0]))
+
+static void ReceiveTask(void)
+{
+	static TestMsg_t msg;
+
+	task_open();
+
+	for (;;)
+	{
+		msg_receive(g_RxTaskID, &msg);
+
+		if (g_nReceived < MAX_RECEIVED)
+		{
+			g_Received[g_nReceived].tick = os_tick_count_get();
+			g_Received[g_nReceived].signal = msg.super.signal;
+			g_nReceived++;
+		}
+	}
+
+	task_close();
+}
+
+/* Posts a periodic, a delayed and an immediate message at tick 0 */
+static void SendTask(void)
+{
+	static TestMsg_t msg;
+
+	task_open();
+
+	msg.super.signal = SIG_PERIODIC;
+	msg_post_every(g_RxTaskID, msg, 50);
+
+	msg.super.signal = SIG_DELAYED;
+	msg_post_in(g_RxTaskID, msg, 30);
+
+	msg.super.signal = SIG_NOW;
+	msg_post(g_RxTaskID, msg);
+
+	for (;;)
+	{
+		task_wait(60000);
+	}
+
+	task_close();
+}
+
+/* Runs the two tasks for RUN_TICKS, in steps of step ticks, 0 for one tickless run */
+static void RunMessages(uint32_t step)
+{
+	uint8_t i;
+
+	os_init();
+
+	/* The receiver has the higher priority, so it takes each message on the tick it falls due */
+	g_RxTaskID = task_create(ReceiveTask, NULL, 1, (Msg_t *)g_RxQueue, 4, sizeof(TestMsg_t));
+	task_create(SendTask, NULL, 2, NULL, 0, 0);
+
+	g_nReceived = 0;
+
+	if (0 == step)
+	{
+		os_posix_run_for(RUN_TICKS);
+	}
+	else
+	{
+		while (os_tick_count_get() < RUN_TICKS)
+		{
+			os_posix_run_for(step);
+		}
+	}
+
+	CHECK_EQ(g_nReceived, N_EXPECTED);
+
+	for (i = 0; (i < g_nReceived) && (i < N_EXPECTED); i++)
+	{
+		CHECK_EQ(g_Received[i].tick, g_Expected[i].tick);
+		CHECK_EQ(g_Received[i].signal, g_Expected[i].signal);
+	}
+}
+
+int main(void)
+{
+	uint32_t wakeups;
+
+	RunMessages(1);
+
+	wakeups = os_posix_wakeups_get();
+	RunMessages(0);
+
+	/* Tickless, the clock jumps to each deadline after tick 0 and then to the end of the run */
+	CHECK_EQ(os_posix_wakeups_get() - wakeups, N_EXPECTED);
+
+	return(TEST_RESULT("test_msgq"));
+}
@@ -0,0 +1,220 @@
+/*
+ * This file is part of the cocoOS port for the ASL head array eFix firmware.
+ */
+/** @file test_ring.c Host test of the ring buffer and the message pool */
+
+#include <stdlib.h>
+#include <string.h>
+#include "cocoos.h"
+#include "test_check.h"
+
+#define RING_SIZE			8
+#define ELEMENT_SIZE		3
+#define RANDOM_STEPS		5000
+#define STREAM_LENGTH		1000
+
+#define POOL_SLOTS			4
+#define SLOT_SIZE			6
+
+/* Random pushes and pops, long enough for the head and tail counts to wrap */
+static void TestRingFifo(void)
+{
+	static uint8_t buffer[RING_SIZE][ELEMENT_SIZE];
+	static uint8_t model[RING_SIZE][ELEMENT_SIZE];
+	Ring_t ring;
+	uint8_t element[ELEMENT_SIZE];
+	uint8_t modelHead;
+	uint8_t modelCount;
+	uint16_t next;
+	uint8_t i;
+	int step;
+
+	ring_init(&ring, buffer, RING_SIZE, ELEMENT_SIZE, NO_EVENT);
+	modelHead = 0;
+	modelCount = 0;
+	next = 0;
+
+	for (step = 0; step < RANDOM_STEPS; step++)
+	{
+		if (rand() % 2)
+		{
+			for (i = 0; i < ELEMENT_SIZE; i++)
+			{
+				element[i] = (uint8_t)(next + i);
+			}
+
+			CHECK_EQ(ring_push(&ring, element), (modelCount < RING_SIZE) ? 1 : 0);
+
+			if (modelCount < RING_SIZE)
+			{
+				memcpy(model[(modelHead + modelCount) % RING_SIZE], element, ELEMENT_SIZE);
+				modelCount++;
+				next++;
+			}
+		}
+		else
+		{
+			CHECK_EQ(ring_pop(&ring, element), (0 != modelCount) ? 1 : 0);
+
+			if (0 != modelCount)
+			{
+				CHECK(0 == memcmp(element, model[modelHead], ELEMENT_SIZE));
+				modelHead = (modelHead + 1) % RING_SIZE;
+				modelCount--;
+			}
+		}
+
+		CHECK_EQ(ring_count(&ring), modelCount);
+	}
+
+	CHECK(next > 255);
+}
+
+/* A consumer task waits for the ring event, fed by a task and by the tick "ISR" */
+static Ring_t g_Ring;
+static uint8_t g_RingBuffer[RING_SIZE];
+static Evt_t g_RingEvent;
+static uint16_t g_Pushed;
+static uint16_t g_Popped;
+static uint8_t g_NextValue;
+
+static void ConsumerTask(void)
+{
+	static uint8_t value;
+
+	task_open();
+
+	for (;;)
+	{
+		while (ring_pop(&g_Ring, &value))
+		{
+			CHECK_EQ(value, (uint8_t)g_Popped);
+			g_Popped++;
+		}
+
+		event_wait(g_RingEvent);
+	}
+
+	task_close();
+}
+
+static void ProducerTask(void)
+{
+	task_open();
+
+	for (;;)
+	{
+		if ((g_Pushed < STREAM_LENGTH) && ring_push(&g_Ring, &g_NextValue))
+		{
+			g_NextValue++;
+			g_Pushed++;
+		}
+
+		task_wait((uint32_t)(1 + rand() % 5));
+	}
+
+	task_close();
+}
+
+static void TickHook(uint32_t now)
+{
+	(void)now;
+
+	if ((g_Pushed < STREAM_LENGTH) && ring_ISR_push(&g_Ring, &g_NextValue))
+	{
+		g_NextValue++;
+		g_Pushed++;
+	}
+}
+
+static void TestRingEvent(void)
+{
+	os_init();
+	g_RingEvent = event_create();
+	ring_init(&g_Ring, g_RingBuffer, RING_SIZE, 1, g_RingEvent);
+
+	task_create(ConsumerTask, NULL, 1, NULL, 0, 0);
+	task_create(ProducerTask, NULL, 2, NULL, 0, 0);
+
+	os_posix_tick_hook_set(TickHook);
+	os_posix_run_for(10000);
+	os_posix_tick_hook_set(NULL);
+
+	CHECK_EQ(g_Pushed, STREAM_LENGTH);
+	CHECK_EQ(g_Popped, STREAM_LENGTH);
+	CHECK_EQ(ring_count(&g_Ring), 0);
+}
+
+/* Slots are handed out once, come back on free, and travel through a ring by handle */
+static void TestPool(void)
+{
+	static uint8_t slots[POOL_SLOTS][SLOT_SIZE];
+	static MsgHandle_t handleBuffer[POOL_SLOTS];
+	MsgPool_t pool;
+	Ring_t ring;
+	MsgHandle_t handles[POOL_SLOTS];
+	MsgHandle_t handle;
+	uint8_t *slot;
+	uint8_t i;
+	uint8_t j;
+
+	msg_pool_init(&pool, slots, POOL_SLOTS, SLOT_SIZE, NO_EVENT);
+	ring_init(&ring, handleBuffer, POOL_SLOTS, sizeof(MsgHandle_t), NO_EVENT);
+
+	CHECK_EQ(msg_pool_free_count(&pool), POOL_SLOTS);
+
+	for (i = 0; i < POOL_SLOTS; i++)
+	{
+		handles[i] = msg_alloc(&pool);
+		CHECK(handles[i] < POOL_SLOTS);
+
+		for (j = 0; j < i; j++)
+		{
+			CHECK(handles[i] != handles[j]);
+		}
+
+		/* Fill the whole slot, the free list byte included */
+		memset(msg_slot_get(&pool, handles[i]), 0xA0 + i, SLOT_SIZE);
+		CHECK_EQ(msg_handle_post(&ring, handles[i]), 1);
+	}
+
+	CHECK_EQ(msg_pool_free_count(&pool), 0);
+	CHECK_EQ(msg_alloc(&pool), NO_MSG_HANDLE);
+
+	for (i = 0; i < POOL_SLOTS; i++)
+	{
+		handle = msg_handle_receive(&ring);
+		CHECK_EQ(handle, handles[i]);
+
+		slot = (uint8_t *)msg_slot_get(&pool, handle);
+
+		for (j = 0; j < SLOT_SIZE; j++)
+		{
+			CHECK_EQ(slot[j], 0xA0 + i);
+		}
+
+		msg_free(&pool, handle);
+	}
+
+	CHECK_EQ(msg_handle_receive(&ring), NO_MSG_HANDLE);
+	CHECK_EQ(msg_pool_free_count(&pool), POOL_SLOTS);
+
+	/* All slots can be allocated again */
+	for (i = 0; i < POOL_SLOTS; i++)
+	{
+		CHECK(msg_alloc(&pool) != NO_MSG_HANDLE);
+	}
+
+	CHECK_EQ(msg_alloc(&pool), NO_MSG_HANDLE);
+}
+
+int main(void)
+{
+	srand(1);
+
+	TestRingFifo();
+	TestRingEvent();
+	TestPool();
+
+	return(TEST_RESULT("test_ring"));
+}
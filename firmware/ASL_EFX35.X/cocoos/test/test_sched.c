@@ -0,0 +1,190 @@
+/*
+ * This file is part of the cocoOS port for the ASL head array eFix firmware.
+ */
+/** @file test_sched.c Host test of the ready bitmap task selection */
+
+#include <stdlib.h>
+#include "cocoos.h"
+#include "test_check.h"
+
+#define RANDOM_RUNS			2000
+#define RANDOM_STEPS		200
+
+static void IdleTask(void)
+{
+}
+
+/* Reference selection: the old scan of all tasks for the highest priority ready one */
+static uint8_t ScanHighestPrioReady(uint8_t nTasks)
+{
+	uint8_t tid;
+	uint8_t best;
+
+	best = NO_TID;
+
+	for (tid = 0; tid < nTasks; tid++)
+	{
+		if ((READY == task_state_get(tid))
+			&& ((NO_TID == best) || (os_task_prio_get(tid) < os_task_prio_get(best))))
+		{
+			best = tid;
+		}
+	}
+
+	return(best);
+}
+
+/* Reference round robin: the ready task with the next lower priority after last, wrapping around */
+static uint8_t ScanNextReady(uint8_t nTasks, uint8_t last)
+{
+	uint8_t tid;
+	uint8_t next;
+
+	next = NO_TID;
+
+	if (NO_TID != last)
+	{
+		for (tid = 0; tid < nTasks; tid++)
+		{
+			if ((READY == task_state_get(tid))
+				&& (os_task_prio_get(tid) > os_task_prio_get(last))
+				&& ((NO_TID == next) || (os_task_prio_get(tid) < os_task_prio_get(next))))
+			{
+				next = tid;
+			}
+		}
+	}
+
+	if (NO_TID == next)
+	{
+		next = ScanHighestPrioReady(nTasks);
+	}
+
+	return(next);
+}
+
+/* Creates nTasks tasks with distinct random priorities */
+static void CreateRandomTasks(uint8_t nTasks)
+{
+	uint8_t used[256] = { 0 };
+	uint8_t prio;
+	uint8_t i;
+
+	os_init();
+
+	for (i = 0; i < nTasks; i++)
+	{
+		do
+		{
+			prio = (uint8_t)(rand() % 255);
+		} while (used[prio]);
+
+		used[prio] = 1;
+		task_create(IdleTask, NULL, prio, NULL, 0, 0);
+	}
+}
+
+/* Applies a random task state change, as the tick ISR and the task API do */
+static void RandomStateChange(uint8_t nTasks)
+{
+	uint8_t tid;
+
+	tid = (uint8_t)(rand() % nTasks);
+
+	switch (rand() % 5)
+	{
+		case 0:
+			os_task_suspend(tid);
+			break;
+		case 1:
+			os_task_resume(tid);
+			break;
+		case 2:
+			os_task_wait_time_set(tid, 0, 1 + rand() % 3);
+			break;
+		case 3:
+			os_task_tick(0, 1);
+			break;
+		default:
+			os_task_ready_set(tid);
+			break;
+	}
+}
+
+static void TestHighestPrio(void)
+{
+	int run;
+	int step;
+	uint8_t nTasks;
+
+	for (run = 0; run < RANDOM_RUNS; run++)
+	{
+		nTasks = (uint8_t)(1 + rand() % N_TASKS);
+		CreateRandomTasks(nTasks);
+
+		for (step = 0; step < RANDOM_STEPS; step++)
+		{
+			RandomStateChange(nTasks);
+			CHECK_EQ(os_task_highest_prio_ready_task(), ScanHighestPrioReady(nTasks));
+		}
+	}
+}
+
+static void TestRoundRobin(void)
+{
+	int run;
+	int step;
+	uint8_t nTasks;
+	uint8_t last;
+	uint8_t next;
+
+	for (run = 0; run < RANDOM_RUNS; run++)
+	{
+		nTasks = (uint8_t)(1 + rand() % N_TASKS);
+		CreateRandomTasks(nTasks);
+		last = NO_TID;
+
+		for (step = 0; step < RANDOM_STEPS; step++)
+		{
+			RandomStateChange(nTasks);
+
+			/* The reference is taken first, os_task_next_ready_task() moves on the last task */
+			next = ScanNextReady(nTasks, last);
+			CHECK_EQ(os_task_next_ready_task(), next);
+			last = next;
+		}
+	}
+}
+
+/* Every ready task is visited once per round, in priority order */
+static void TestRoundRobinCycle(void)
+{
+	/* Priority 50 - tid * 3 makes tid 7 the highest, tid 3 is suspended */
+	static const uint8_t order[7] = { 7, 6, 5, 4, 2, 1, 0 };
+	uint8_t i;
+
+	os_init();
+
+	for (i = 0; i < 8; i++)
+	{
+		task_create(IdleTask, NULL, (uint8_t)(50 - i * 3), NULL, 0, 0);
+	}
+
+	os_task_suspend(3);
+
+	for (i = 0; i < 7 * 3; i++)
+	{
+		CHECK_EQ(os_task_next_ready_task(), order[i % 7]);
+	}
+}
+
+int main(void)
+{
+	srand(1);
+
+	TestHighestPrio();
+	TestRoundRobin();
+	TestRoundRobinCycle();
+
+	return(TEST_RESULT("test_sched"));
+}
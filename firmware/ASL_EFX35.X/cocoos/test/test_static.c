@@ -0,0 +1,120 @@
+/*
+ * This file is part of the cocoOS port for the ASL head array eFix firmware.
+ */
+/** @file test_static.c Host test of the OS_STATIC_TASKS task table in static/rtos_task_priorities.h */
+
+#include <stddef.h>
+#include <string.h>
+#include "cocoos.h"
+#include "test_check.h"
+
+#define RUN_TICKS			1000
+#define MAX_ORDER			6
+
+/* The message of the table must start like Msg_t */
+typedef char TEST_MSG_LAYOUT[(offsetof(TestMsg_t, value) == sizeof(Msg_t)) ? 1 : -1];
+
+static uint32_t g_HiRuns;
+static uint32_t g_LoRuns;
+static uint32_t g_Received;
+static uint8_t g_LastValue;
+
+/* Task run order, one letter per run */
+static char g_Order[MAX_ORDER + 1];
+static uint8_t g_nOrder;
+
+static void RecordRun(char task)
+{
+	if (g_nOrder < MAX_ORDER)
+	{
+		g_Order[g_nOrder++] = task;
+	}
+}
+
+/* Posts a message to the receive task on every release */
+void HiTask(void)
+{
+	static uint32_t release;
+	static TestMsg_t msg;
+
+	task_open();
+
+	release = os_tick_count_get();
+
+	for (;;)
+	{
+		RecordRun('H');
+		g_HiRuns++;
+
+		msg.signal = 1;
+		msg.value = (uint8_t)g_HiRuns;
+		msg_post(RX_TASK_ID, msg);
+
+		task_wait_until(release, HI_TASK_PERIOD);
+	}
+
+	task_close();
+}
+
+void RxTask(void)
+{
+	static TestMsg_t msg;
+
+	task_open();
+
+	for (;;)
+	{
+		msg_receive(RX_TASK_ID, &msg);
+		RecordRun('R');
+		g_Received++;
+		CHECK_EQ(msg.value, (uint8_t)(g_LastValue + 1));
+		g_LastValue = msg.value;
+	}
+
+	task_close();
+}
+
+void LoTask(void)
+{
+	static uint32_t release;
+
+	task_open();
+
+	release = os_tick_count_get();
+
+	for (;;)
+	{
+		RecordRun('L');
+		g_LoRuns++;
+		task_wait_until(release, LO_TASK_PERIOD);
+	}
+
+	task_close();
+}
+
+int main(void)
+{
+	CHECK_EQ(N_TASKS, 3);
+	CHECK_EQ(N_QUEUES, 1);
+
+	/* No task_create(), the control blocks are built from the table */
+	os_init();
+	os_posix_run_for(RUN_TICKS);
+
+	printf("order %s, high %lu, received %lu, low %lu\n", g_Order,
+		(unsigned long)g_HiRuns, (unsigned long)g_Received, (unsigned long)g_LoRuns);
+
+	/* Tasks run in priority order, the id of a task is its row in the table */
+	CHECK_EQ(HI_TASK_ID, 0);
+	CHECK_EQ(RX_TASK_ID, 1);
+	CHECK_EQ(LO_TASK_ID, 2);
+	CHECK(0 == strcmp(g_Order, "HRLHRH"));
+
+	CHECK_EQ(g_HiRuns, RUN_TICKS / HI_TASK_PERIOD);
+	CHECK_EQ(g_Received, g_HiRuns);
+	CHECK_EQ(g_LoRuns, RUN_TICKS / LO_TASK_PERIOD);
+	CHECK_EQ(task_overruns_get(HI_TASK_ID), 0);
+	CHECK_EQ(task_overruns_get(LO_TASK_ID), 0);
+
+	return(TEST_RESULT("test_static"));
+}
@@ -0,0 +1,315 @@
+/*
+ * This file is part of the cocoOS port for the ASL head array eFix firmware.
+ */
+/** @file test_timer.c Host test of the master clock timer list, periodic tasks and idle time */
+
+#include <stdlib.h>
+#include "cocoos.h"
+#include "test_check.h"
+
+#define RANDOM_RUNS			500
+#define RANDOM_STEPS		500
+#define MAX_WAIT			40
+#define SIGNAL_TIMEOUT		25
+
+typedef enum
+{
+	MODEL_READY,
+	MODEL_WAITING,
+	MODEL_SUSPENDED
+} ModelState_t;
+
+/* Task state and remaining wait time, kept apart from the kernel by the test */
+typedef struct
+{
+	ModelState_t state;
+	ModelState_t savedState;
+	uint32_t time;
+} ModelTask_t;
+
+static ModelTask_t g_Model[N_TASKS];
+
+static uint32_t g_TaskData[N_TASKS];
+
+static void IdleTask(void)
+{
+}
+
+static void ModelTick(uint32_t ticks)
+{
+	uint8_t tid;
+
+	for (tid = 0; tid < N_TASKS; tid++)
+	{
+		if (MODEL_WAITING == g_Model[tid].state)
+		{
+			if (g_Model[tid].time <= ticks)
+			{
+				g_Model[tid].state = MODEL_READY;
+			}
+			else
+			{
+				g_Model[tid].time -= ticks;
+			}
+		}
+	}
+}
+
+/* The idle time os_cbkSleep() gets: none if a task is ready, else up to the first timeout */
+static uint32_t ModelIdleTicks(void)
+{
+	uint32_t ticks;
+	uint8_t tid;
+
+	ticks = OS_IDLE_FOREVER;
+
+	for (tid = 0; tid < N_TASKS; tid++)
+	{
+		if (MODEL_READY == g_Model[tid].state)
+		{
+			return(0);
+		}
+
+		if ((MODEL_WAITING == g_Model[tid].state) && (g_Model[tid].time < ticks))
+		{
+			ticks = g_Model[tid].time;
+		}
+	}
+
+	return(ticks);
+}
+
+/* Waits, suspends, resumes and multi tick advances against a model of per task countdowns */
+static void TestTimerList(void)
+{
+	static const TaskState_t states[] = { READY, WAITING_TIME, SUSPENDED };
+	int run;
+	int step;
+	uint8_t tid;
+	uint32_t ticks;
+
+	for (run = 0; run < RANDOM_RUNS; run++)
+	{
+		os_init();
+
+		for (tid = 0; tid < N_TASKS; tid++)
+		{
+			task_create(IdleTask, &g_TaskData[tid], (uint8_t)(tid + 1), NULL, 0, 0);
+			g_Model[tid].state = MODEL_READY;
+		}
+
+		for (step = 0; step < RANDOM_STEPS; step++)
+		{
+			tid = (uint8_t)(rand() % N_TASKS);
+
+			switch (rand() % 5)
+			{
+				case 0:
+					if (MODEL_SUSPENDED != g_Model[tid].state)
+					{
+						g_Model[tid].time = (uint32_t)(1 + rand() % MAX_WAIT);
+						g_Model[tid].state = MODEL_WAITING;
+						os_task_wait_time_set(tid, 0, g_Model[tid].time);
+					}
+					break;
+				case 1:
+					if (MODEL_SUSPENDED != g_Model[tid].state)
+					{
+						g_Model[tid].savedState = g_Model[tid].state;
+						g_Model[tid].state = MODEL_SUSPENDED;
+					}
+					os_task_suspend(tid);
+					break;
+				case 2:
+					if (MODEL_SUSPENDED == g_Model[tid].state)
+					{
+						g_Model[tid].state = g_Model[tid].savedState;
+					}
+					os_task_resume(tid);
+					break;
+				case 3:
+					if (MODEL_WAITING == g_Model[tid].state)
+					{
+						g_Model[tid].state = MODEL_READY;
+						os_task_ready_set(tid);
+					}
+					break;
+				default:
+					ticks = (uint32_t)(1 + rand() % 3);
+					os_task_tick(0, ticks);
+					ModelTick(ticks);
+					break;
+			}
+
+			for (tid = 0; tid < N_TASKS; tid++)
+			{
+				CHECK_EQ(task_state_get(tid), states[g_Model[tid].state]);
+			}
+
+			CHECK_EQ(os_idle_ticks_get(), ModelIdleTicks());
+		}
+	}
+}
+
+/* Running tasks wake on the exact tick their task_wait() ends */
+static uint32_t g_Due[3];
+static uint32_t g_Wakes;
+
+#define WAIT_TASK(n)	static void WaitTask##n(void)											\
+						{																		\
+							static uint32_t wait;												\
+							task_open();														\
+							for (;;)															\
+							{																	\
+								wait = (uint32_t)(1 + rand() % MAX_WAIT);						\
+								g_Due[n] = os_tick_count_get() + wait;							\
+								task_wait(wait);												\
+								CHECK_EQ(os_tick_count_get(), g_Due[n]);						\
+								g_Wakes++;														\
+							}																	\
+							task_close();														\
+						}
+
+WAIT_TASK(0)
+WAIT_TASK(1)
+WAIT_TASK(2)
+
+/* An event wait times out on time, or ends early when the event comes */
+static Evt_t g_Event;
+static uint32_t g_EventWaits;
+
+static void EventWaitTask(void)
+{
+	static uint32_t start;
+
+	task_open();
+
+	for (;;)
+	{
+		start = os_tick_count_get();
+		event_wait_timeout(g_Event, SIGNAL_TIMEOUT);
+		CHECK(os_tick_count_get() - start <= SIGNAL_TIMEOUT);
+		g_EventWaits++;
+	}
+
+	task_close();
+}
+
+static void SignalTask(void)
+{
+	task_open();
+
+	for (;;)
+	{
+		task_wait((uint32_t)(1 + rand() % (2 * SIGNAL_TIMEOUT)));
+		event_signal(g_Event);
+	}
+
+	task_close();
+}
+
+static void TestTaskWait(void)
+{
+	os_init();
+	g_Event = event_create();
+
+	task_create(WaitTask0, NULL, 1, NULL, 0, 0);
+	task_create(WaitTask1, NULL, 2, NULL, 0, 0);
+	task_create(WaitTask2, NULL, 3, NULL, 0, 0);
+	task_create(EventWaitTask, NULL, 4, NULL, 0, 0);
+	task_create(SignalTask, NULL, 5, NULL, 0, 0);
+
+	os_posix_run_for(1000000);
+
+	CHECK(g_Wakes > 3 * 1000000 / MAX_WAIT);
+	CHECK(g_EventWaits > 1000000 / SIGNAL_TIMEOUT);
+}
+
+/* A periodic task that overruns once starts its periods over from the late release */
+static const uint32_t g_ExpectedReleases[] = { 0, 10, 20, 45, 55, 65, 75, 85, 95 };
+#define N_RELEASES		(sizeof(g_ExpectedReleases) / sizeof(g_ExpectedReleases[0]))
+
+static uint32_t g_Releases[N_RELEASES];
+static uint8_t g_nReleases;
+static uint8_t g_PeriodicTaskID;
+
+static void PeriodicTask(void)
+{
+	static uint32_t release;
+
+	task_open();
+
+	release = os_tick_count_get();
+
+	for (;;)
+	{
+		if (g_nReleases < N_RELEASES)
+		{
+			g_Releases[g_nReleases++] = os_tick_count_get();
+		}
+
+		if (20 == os_tick_count_get())
+		{
+			task_wait(25);
+		}
+
+		task_wait_until(release, 10);
+	}
+
+	task_close();
+}
+
+static void TestWaitUntil(void)
+{
+	uint8_t i;
+
+	os_init();
+	g_PeriodicTaskID = task_create(PeriodicTask, NULL, 1, NULL, 0, 0);
+
+	os_posix_run_for(100);
+
+	CHECK_EQ(g_nReleases, N_RELEASES);
+
+	for (i = 0; i < g_nReleases; i++)
+	{
+		CHECK_EQ(g_Releases[i], g_ExpectedReleases[i]);
+	}
+
+	CHECK_EQ(task_overruns_get(g_PeriodicTaskID), 1);
+}
+
+#ifdef OS_TASK_DATA
+static void DataTask(void)
+{
+	task_open();
+	CHECK(task_get_data() == &g_TaskData[0]);
+	g_TaskData[0]++;
+	task_wait(60000);
+	task_close();
+}
+
+static void TestTaskData(void)
+{
+	g_TaskData[0] = 0;
+
+	os_init();
+	task_create(DataTask, &g_TaskData[0], 1, NULL, 0, 0);
+	os_posix_run_for(10);
+
+	CHECK_EQ(g_TaskData[0], 1);
+}
+#endif
+
+int main(void)
+{
+	srand(1);
+
+	TestTimerList();
+	TestTaskWait();
+	TestWaitUntil();
+#ifdef OS_TASK_DATA
+	TestTaskData();
+#endif
+
+	return(TEST_RESULT("test_timer"));
+}
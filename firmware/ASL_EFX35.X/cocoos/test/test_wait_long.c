@@ -0,0 +1,32 @@
+/*
+ * This file is part of the cocoOS port for the ASL head array eFix firmware.
+ */
+/** @file test_wait_long.c Host test of a task wait longer than 16 bit timeouts allow */
+
+#include "cocoos.h"
+#include "test_check.h"
+
+#define LONG_WAIT			70000UL
+
+static uint32_t g_WokeAt;
+
+static void LongWaitTask(void)
+{
+	task_open();
+	task_wait(LONG_WAIT);
+	g_WokeAt = os_tick_count_get();
+	task_wait(60000);
+	task_close();
+}
+
+/* With OS_TASK_TIME_BITS 16 the wait asserts, the Makefile expects the assert */
+int main(void)
+{
+	os_init();
+	task_create(LongWaitTask, NULL, 1, NULL, 0, 0);
+	os_posix_run_for(LONG_WAIT + 10);
+
+	CHECK_EQ(g_WokeAt, LONG_WAIT);
+
+	return(TEST_RESULT("test_wait_long"));
+}
@@ -22,6 +22,12 @@
 // If it's jumpered out, comment the following line.
 #define USE_12VOLT_REGULATOR
 
+// Define this for proportional (analog) pads. The pads are then read by the ADC
+// and give a graded drive demand. If not defined, the pads are digital switches.
+// NOTE: On the PIC18F4550 this makes RE0 - RE2 analog, so the HHP interface can not
+// NOTE: be used with it. Its clock and data lines would always read low.
+//#define HEAD_ARRAY_PROPORTIONAL_PADS
+
 /* ******************************   Tests   ******************************* */
 
 // Tests. Generally, only one should be enabled. Unless it is known that >1 test can be run with
@@ -41,6 +47,11 @@
 // Basic EEPROM comms test
 //#define TEST_BASIC_EEPROM_CONTROL
 
+// Holds TEST_GPIO_1 high while the eFix task builds and queues its messages.
+// Needs DEBUG. The pulse width on a scope, at 4 clocks per instruction cycle,
+// gives the cycles spent per run of the eFix task.
+//#define EFIX_COMMS_TIMING_TEST
+
 #endif // CONFIG_H
 
 // end of file.
@@ -13,6 +13,11 @@
 #ifndef HEAD_ARRAY_COMMON_H
 #define HEAD_ARRAY_COMMON_H
 
+/* ***************************    Includes     **************************** */
+
+// from stdlib
+#include <stdint.h>
+
 /* ******************************   Types   ******************************* */
 
 typedef enum
@@ -26,6 +31,21 @@ typedef enum
 	HEAD_ARRAY_SENSOR_EOL
 } HeadArraySensor_t;
 
+typedef enum
+{
+	HEAD_ARR_INPUT_DIGITAL,
+	HEAD_ARR_INPUT_PROPORTIONAL,
+
+	// Nothing else may be defined past this point!
+	HEAD_ARR_INPUT_EOL
+} HeadArrayInputType_t;
+
+/* ******************************   Macros   ****************************** */
+
+// Pads as a bitmask, one bit per HeadArraySensor_t, set when the pad is active.
+#define HEAD_ARRAY_PAD_BIT(sensor)      ((uint8_t)(1u << (sensor)))
+#define HEAD_ARRAY_PADS_LEFT_RIGHT      (HEAD_ARRAY_PAD_BIT(HEAD_ARRAY_SENSOR_LEFT) | HEAD_ARRAY_PAD_BIT(HEAD_ARRAY_SENSOR_RIGHT))
+
 //typedef enum
 //{
 //	DAC_SELECT_FORWARD_BACKWARD,
@@ -32,6 +32,7 @@
 
 // from stdlib
 #include <stdbool.h>
+#include <stdint.h>
 
 /* ******************************   Types   ******************************* */
 
@@ -52,6 +53,7 @@ bool stopwatchIsActive(StopWatch_t *stop_watch);
 TimerTick_t stopwatchTimeElapsed(StopWatch_t *stop_watch, bool zero_after_check);
 TimerTick_t stopwatchTimeUntilLimit(StopWatch_t *stop_watch, TimerTick_t time_to_check_ms);
 void stopwatchTick(void);
+void stopwatchTickN(uint8_t num_ticks);
 
 #endif // STOPWATCH_H
 
@@ -147,5 +147,17 @@ void stopwatchTick(void)
 	curr_time_ms++;
 }
 
+//-------------------------------
+// Function: stopwatchTickN
+//
+// Description: increments the internal tick for this module by several 1 ms ticks at once. Used when the tick
+//		interrupt has been slowed down while idling.
+//
+//-------------------------------
+void stopwatchTickN(uint8_t num_ticks)
+{
+	curr_time_ms += num_ticks;
+}
+
 // end of file.
 //-------------------------------------------------------------------------
@@ -27,15 +27,48 @@
 // from RTOS
 #include "cocoos.h"
 
+#include "RS232.h"
+
+/* **************************   Local Macro Declarations   *************************** */
+
+// Size of the transmit ring, in characters. Must be a power of 2, at most 128.
+// Holds a steering and a speed message of the eFix.
+#define RS232_TX_RING_SIZE (16)
+// Size of the receive ring, in characters. Must be a power of 2, at most 128.
+// About 2.8 ms of characters at 115.2K, for the parser task to take them.
+#define RS232_RX_RING_SIZE (32)
+
+#define ISR_LOW_PRIO_SET_VAL (0)
+
+/* **************************   File Scope Variables   *************************** */
+
+// Characters waiting to go out. The tasks push, the transmit interrupt pops.
+static Ring_t g_TxRing;
+static uint8_t g_TxRingBuffer[RS232_TX_RING_SIZE];
+static Evt_t g_TxDoneEvent;     // Signaled when the ring runs empty
+
+// Characters received. The receive interrupt pushes, a task pops.
+static Ring_t g_RxRing;
+static uint8_t g_RxRingBuffer[RS232_RX_RING_SIZE];
+static Evt_t g_RxEvent;         // Signaled for each character received
+static RS232_ReceiveErrors_t g_RxErrors;
+
 //------------------------------------------------------------------------------
 // Function: RS232_Initialize
 // Description: This function initializes the 18LF4550 UART communication hardware.
-//      Note that the interrupts for receive and transmit are disabled.
+//      Note that the receive interrupt is enabled. The transmit interrupt is
+//      enabled while there are characters in the transmit ring.
+//      Must be called before os_start(), as it creates events.
 // Returns: void
 //------------------------------------------------------------------------------
 
 void RS232_Initialize (void)
 {
+    ring_init (&g_TxRing, g_TxRingBuffer, RS232_TX_RING_SIZE, 1, NO_EVENT);
+    g_TxDoneEvent = event_create();
+    g_RxEvent = event_create();
+    ring_init (&g_RxRing, g_RxRingBuffer, RS232_RX_RING_SIZE, 1, g_RxEvent);
+
     // Set I/O Pin Directions
     TRISCbits.RC6 = 0;      // Port C pin 6 is Transmit.
     TRISCbits.RC7 = 1;      // Port C pin 7 is Receive.
@@ -69,53 +102,206 @@ void RS232_Initialize (void)
     // Reference: Use TXREG to transmit data
     // Reference: Use RCREG to receive data
     
-    PIE1bits.RCIE = 0;      // "1" enables Receive interrupt
+    IPR1bits.RCIP = ISR_LOW_PRIO_SET_VAL;
+    IPR1bits.TXIP = ISR_LOW_PRIO_SET_VAL;
+    PIE1bits.RCIE = 1;      // "1" enables Receive interrupt
     PIE1bits.TXIE = 0;      // "1" enables the Transmit complete interrupt.
 }
 //------------------------------------------------------------------------------
 // Function: RS232_TransmitReady()
-// Description: Evaluates the CPU Regs to determine if it's OK to send
+// Description: Evaluates if there is room in the transmit ring for
 //      a character.
-// Returns: true if transmit buffer is empty and ready
+// Returns: true if transmit ring has room
 //          false if caller should wait just a little bit longer.
 //------------------------------------------------------------------------------
 
 bool RS232_TransmitReady (void)
 {
-    return (PIR1bits.TXIF == 1); // "1" = transmit buffer is empty
+    return (ring_count (&g_TxRing) < RS232_TX_RING_SIZE);
 }
 
 //------------------------------------------------------------------------------
 // Function: RS232_TransmitChar
-// Description: Send a character out via the RS232 UART hardwawre. But only
-//      if the transmit buffer is empty. If not, loop until it is.
+// Description: Queue a character to go out via the RS232 UART hardwawre. But only
+//      if the transmit ring has room. If not, loop until it has.
 // Returns: void
 //------------------------------------------------------------------------------
 
 void RS232_TransmitChar (unsigned char item)
 {
-    while (PIR1bits.TXIF == 0)  // "0" = Transmit buffer not empty.
+    while (ring_push (&g_TxRing, &item) == 0)  // "0" = Transmit ring is full.
         ;
-    TXREG = item;
+    PIE1bits.TXIE = 1;      // The interrupt sends it
+}
+
+//------------------------------------------------------------------------------
+// Function: RS232_TransmitFrame
+// Description: Queue a whole frame to go out via the RS232 UART hardware, and
+//      return at once. The frame is copied, the caller may reuse the buffer.
+//      Either all of the frame is queued or none of it.
+// Returns: true if the frame was queued
+//          false if the transmit ring does not have room for it.
+//------------------------------------------------------------------------------
+
+bool RS232_TransmitFrame (const unsigned char *frame, uint8_t length)
+{
+    if ((uint8_t)(RS232_TX_RING_SIZE - ring_count (&g_TxRing)) < length)
+    {
+        return false;
+    }
+
+    for (uint8_t i = 0; i < length; ++i)
+    {
+        (void)ring_push (&g_TxRing, &frame[i]);
+    }
+    PIE1bits.TXIE = 1;      // The interrupt sends it
+    return true;
+}
+
+//------------------------------------------------------------------------------
+// Function: RS232_TransmitIdle
+// Description: Evaluates if everything queued has been handed to the UART. The
+//      ISR turns the transmit interrupt off before it signals the done event,
+//      so once this is true the event has been signaled. The last character
+//      may still be in the transmit shift register.
+// Returns: true if the transmitter is idle
+//------------------------------------------------------------------------------
+
+bool RS232_TransmitIdle (void)
+{
+    return (PIE1bits.TXIE == 0);
+}
+
+//------------------------------------------------------------------------------
+// Function: RS232_TransmitDoneEvent
+// Description: The event signaled when the transmit ring runs empty. The last
+//      character is then still being shifted out, about 87 us at 115.2K.
+// Returns: The event
+//------------------------------------------------------------------------------
+
+Evt_t RS232_TransmitDoneEvent (void)
+{
+    return g_TxDoneEvent;
+}
+
+//------------------------------------------------------------------------------
+// Function: RS232_TransmitIsr
+// Description: Moves the next character from the transmit ring to the UART
+//      while the transmit buffer is empty. Must be called from the low priority ISR.
+// Returns: void
+//------------------------------------------------------------------------------
+
+void RS232_TransmitIsr (void)
+{
+    unsigned char item;
+
+    if ((PIE1bits.TXIE == 1) && (PIR1bits.TXIF == 1))
+    {
+        if (ring_pop (&g_TxRing, &item) != 0)
+        {
+            TXREG = item;
+        }
+        else
+        {
+            PIE1bits.TXIE = 0;  // TXIF stays set while the buffer is empty
+            event_ISR_signal (g_TxDoneEvent);
+        }
+    }
 }
 
 //------------------------------------------------------------------------------
 // Function: RS232_GetReceivedChar
-// Description: Gets a character from the UART hardware.
+// Description: Gets the oldest character from the receive ring. Only one task
+//      may take the received characters.
 // Returns: true if a character is was received
 //          false if no character received.
 //------------------------------------------------------------------------------
 bool RS232_GetReceivedChar (unsigned char *item)
 {
-    if (PIR1bits.RCIF != 0) // non0 = we got a character
+    if (ring_pop (&g_RxRing, item) != 0)
     {
-        *item = RCREG;
         return true;
     }
     *item = 0x00;
     return false;
 }
 
+//------------------------------------------------------------------------------
+// Function: RS232_ReceiveEvent
+// Description: The event signaled when a character is put in the receive ring.
+// Returns: The event
+//------------------------------------------------------------------------------
+
+Evt_t RS232_ReceiveEvent (void)
+{
+    return g_RxEvent;
+}
+
+//------------------------------------------------------------------------------
+// Function: RS232_ReceivePending
+// Description: Evaluates if the receive ring holds characters. The ISR puts a
+//      character in the ring before it signals the receive event.
+// Returns: true if a character is waiting to be taken
+//------------------------------------------------------------------------------
+
+bool RS232_ReceivePending (void)
+{
+    return (ring_count (&g_RxRing) != 0);
+}
+
+//------------------------------------------------------------------------------
+// Function: RS232_ReceiveErrorsGet
+// Description: Copies the counts of receive errors since power up. They wrap.
+// Returns: void
+//------------------------------------------------------------------------------
+
+void RS232_ReceiveErrorsGet (RS232_ReceiveErrors_t *errors)
+{
+    *errors = g_RxErrors;
+}
+
+//------------------------------------------------------------------------------
+// Function: RS232_ReceiveIsr
+// Description: Moves the received characters from the UART to the receive ring.
+//      A character with a framing error is dropped. After an overrun the UART
+//      stops receiving, so the receiver is restarted. The parser finds the
+//      next message by itself. Must be called from the low priority ISR.
+// Returns: void
+//------------------------------------------------------------------------------
+
+void RS232_ReceiveIsr (void)
+{
+    unsigned char item;
+    bool framingError;
+
+    if (PIE1bits.RCIE == 0)
+    {
+        return;
+    }
+
+    // The UART holds up to 2 characters.
+    while (PIR1bits.RCIF == 1)
+    {
+        framingError = (RCSTAbits.FERR == 1);   // Of the character on top, read before RCREG
+        item = RCREG;
+        if (framingError)
+        {
+            ++g_RxErrors.framing;
+        }
+        else if (ring_ISR_push (&g_RxRing, &item) == 0)
+        {
+            ++g_RxErrors.dropped;
+        }
+    }
+
+    if (RCSTAbits.OERR == 1)
+    {
+        RCSTAbits.CREN = 0;     // Clearing CREN clears OERR
+        RCSTAbits.CREN = 1;
+        ++g_RxErrors.overrun;
+    }
+}
+
 // END OF FILE
 
 
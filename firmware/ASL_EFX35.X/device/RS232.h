@@ -31,39 +31,117 @@
 #define	XC_HEADER_TEMPLATE_H
 
 #include <xc.h> // include processor files - each processor file is guarded.  
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "cocoos.h"
+
+// Counts of receive errors. They wrap.
+typedef struct
+{
+    uint8_t overrun;    // The UART was not read in time, characters were lost
+    uint8_t framing;    // A character had no stop bit and was dropped
+    uint8_t dropped;    // The receive ring was full, the character was dropped
+} RS232_ReceiveErrors_t;
 
 //------------------------------------------------------------------------------
 // Function: RS232_Initialize
 // Description: This function initializes the 18LF4550 UART communication hardware.
-//      Note that the interrupts for receive and transmit are disabled.
+//      Note that the receive interrupt is enabled. The transmit interrupt is
+//      enabled while there are characters in the transmit ring.
+//      Must be called before os_start(), as it creates events.
 // Returns: void
 //------------------------------------------------------------------------------
 void RS232_Initialize (void);
 
 //------------------------------------------------------------------------------
 // Function: RS232_TransmitReady()
-// Description: Evaluates the CPU Regs to determine if it's OK to send
+// Description: Evaluates if there is room in the transmit ring for
 //      a character.
-// Returns: true if transmit buffer is empty and ready
+// Returns: true if transmit ring has room
 //          false if caller should wait just a little bit longer.
 //------------------------------------------------------------------------------
 bool RS232_TransmitReady (void);
 
 //------------------------------------------------------------------------------
 // Function: RS232_TransmitChar
-// Description: Send a character out via the RS232 UART hardwawre. But only
-//      if the transmit buffer is empty. If not, loop until it is.
+// Description: Queue a character to go out via the RS232 UART hardwawre. But only
+//      if the transmit ring has room. If not, loop until it has.
 // Returns: void
 //------------------------------------------------------------------------------
 void RS232_TransmitChar (unsigned char item);
 
+//------------------------------------------------------------------------------
+// Function: RS232_TransmitFrame
+// Description: Queue a whole frame to go out via the RS232 UART hardware, and
+//      return at once. The frame is copied, the caller may reuse the buffer.
+//      Either all of the frame is queued or none of it.
+// Returns: true if the frame was queued
+//          false if the transmit ring does not have room for it.
+//------------------------------------------------------------------------------
+bool RS232_TransmitFrame (const unsigned char *frame, uint8_t length);
+
+//------------------------------------------------------------------------------
+// Function: RS232_TransmitIdle
+// Description: Evaluates if everything queued has been handed to the UART, and
+//      so the done event has been signaled.
+// Returns: true if the transmitter is idle
+//------------------------------------------------------------------------------
+bool RS232_TransmitIdle (void);
+
+//------------------------------------------------------------------------------
+// Function: RS232_TransmitDoneEvent
+// Description: The event signaled when the transmit ring runs empty.
+// Returns: The event
+//------------------------------------------------------------------------------
+Evt_t RS232_TransmitDoneEvent (void);
+
+//------------------------------------------------------------------------------
+// Function: RS232_TransmitIsr
+// Description: Moves the next character from the transmit ring to the UART
+//      while the transmit buffer is empty. Must be called from the low priority ISR.
+// Returns: void
+//------------------------------------------------------------------------------
+void RS232_TransmitIsr (void);
+
 //------------------------------------------------------------------------------
 // Function: RS232_GetReceivedChar
-// Description: Gets a character from the UART hardware.
+// Description: Gets the oldest character from the receive ring. Only one task
+//      may take the received characters.
 // Returns: true if a character is was received
 //          false if no character received.
 //------------------------------------------------------------------------------
 bool RS232_GetReceivedChar (unsigned char *item);
 
+//------------------------------------------------------------------------------
+// Function: RS232_ReceiveEvent
+// Description: The event signaled when a character is put in the receive ring.
+// Returns: The event
+//------------------------------------------------------------------------------
+Evt_t RS232_ReceiveEvent (void);
+
+//------------------------------------------------------------------------------
+// Function: RS232_ReceivePending
+// Description: Evaluates if the receive ring holds characters.
+// Returns: true if a character is waiting to be taken
+//------------------------------------------------------------------------------
+bool RS232_ReceivePending (void);
+
+//------------------------------------------------------------------------------
+// Function: RS232_ReceiveErrorsGet
+// Description: Copies the counts of receive errors since power up.
+// Returns: void
+//------------------------------------------------------------------------------
+void RS232_ReceiveErrorsGet (RS232_ReceiveErrors_t *errors);
+
+//------------------------------------------------------------------------------
+// Function: RS232_ReceiveIsr
+// Description: Moves the received characters from the UART to the receive ring,
+//      and recovers from overrun and framing errors. Must be called from the
+//      low priority ISR.
+// Returns: void
+//------------------------------------------------------------------------------
+void RS232_ReceiveIsr (void);
+
 #endif	/* XC_HEADER_TEMPLATE_H */
 
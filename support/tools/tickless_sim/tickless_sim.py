@@ -0,0 +1,87 @@
+#
+# Host side simulation of the cocoOS tick, with and without OS_TICKLESS_IDLE.
+#
+# Every task in the firmware is a loop that does its work and then calls task_wait() with a fixed
+# delay. The task delays are read from the firmware headers, the run time of the tasks is assumed
+# to be short compared to a tick. The simulation counts how many times the tick timer interrupt
+# wakes the CPU per second, for the 1 ms tick and for the tickless idle tick, where the timer 2
+# postscaler stretches the tick period up to the first timeout (at most 16 ticks).
+#
+# Usage: python tickless_sim.py [seconds]
+#
+import re
+import sys
+from os import path
+
+FIRMWARE_DIR = path.join(path.dirname(path.abspath(__file__)), '..', '..', '..', 'firmware', 'ASL_EFX35.X')
+
+# Max number of ticks one timer 2 interrupt can cover, see SYS_TICK_MAX_IDLE_TICKS in bsp.c
+MAX_IDLE_TICKS = 16
+
+# (task name, file, delay macro) of the tasks created in main.c
+TASKS = [
+	('Main', 'app/inc/rtos_task_priorities.h', 'MAIN_TASK_DELAY'),
+	('Beeper', 'app/inc/rtos_task_priorities.h', 'BEEPER_TASK_DELAY'),
+	('Head array', 'app/inc/rtos_task_priorities.h', 'HEAD_ARRAY_TASK_DELAY'),
+	('User button', 'app/inc/rtos_task_priorities.h', 'USER_BUTTON_TASK_DELAY'),
+	('eFix', 'app/eFix_Communication.c', 'EFIX_COMM_TASK_DELAY'),
+	('Supervisor', 'app/app_common.c', 'SYS_SUPERVISOR_TASK_EXECUTION_RATE_ms'),
+]
+
+
+#
+# Reads the value of a #define from a firmware file.
+#
+def ReadDefine(file_name, macro):
+	with open(path.join(FIRMWARE_DIR, file_name)) as f:
+		match = re.search(r'^#define\s+' + macro + r'\s+\(?\s*(\d+)', f.read(), re.M)
+	if match is None:
+		raise ValueError('{0} not found in {1}'.format(macro, file_name))
+	return int(match.group(1))
+# End of ReadDefine
+
+
+#
+# Runs the task set for a number of ticks and returns the number of tick interrupts.
+#
+def CountTickInterrupts(delays, num_ticks, tickless):
+	deadlines = list(delays)
+	now = 0
+	interrupts = 0
+
+	while now < num_ticks:
+		if tickless:
+			# os_idle_ticks_get(): ticks until the first timeout, capped by the postscaler
+			period = min(min(deadlines) - now, MAX_IDLE_TICKS)
+		else:
+			period = 1
+
+		now += period
+		interrupts += 1
+
+		# os_task_tick(0, period) makes the expired tasks ready, they run and wait again
+		for i in range(len(deadlines)):
+			if deadlines[i] <= now:
+				deadlines[i] = now + delays[i]
+
+	return interrupts
+# End of CountTickInterrupts
+
+
+if __name__ == "__main__":
+	seconds = int(sys.argv[1]) if len(sys.argv) > 1 else 10
+	num_ticks = seconds * 1000
+
+	delays = []
+	for name, file_name, macro in TASKS:
+		delay = ReadDefine(file_name, macro)
+		delays.append(delay)
+		print('{0:<12} task_wait({1} ms)'.format(name, delay))
+
+	periodic = CountTickInterrupts(delays, num_ticks, False)
+	tickless = CountTickInterrupts(delays, num_ticks, True)
+
+	print('')
+	print('1 ms tick:     {0:7.1f} wakeups/s'.format(periodic / float(seconds)))
+	print('Tickless idle: {0:7.1f} wakeups/s'.format(tickless / float(seconds)))
+	print('Reduction:     {0:7.1f} %'.format(100.0 * (periodic - tickless) / periodic))
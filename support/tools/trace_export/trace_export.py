@@ -0,0 +1,166 @@
+#
+# Converts a cocoOS kernel trace captured from the RS232 port (OS_TRACE, app/trace_app.c) into
+# Chrome trace JSON, which can be opened in chrome://tracing or https://ui.perfetto.dev.
+#
+# Each task is a track, with a slice from every dispatch to the following yield. Event signals,
+# semaphores, message posts and lost records are instant events on the kernel track.
+#
+# The records carry the 16 bit Timer 1 count (3.2 us, wraps after 209 ms). The time of each record
+# is rebuilt from the difference to the one before, so there must be a record at least every
+# 209 ms, which the 20 ms supervisor task guarantees. Time is unreliable across lost records.
+#
+# Usage: python trace_export.py capture.bin trace.json [--names 0=Main,1=eFix,...] [--period TID]
+#
+#   --names   names for the task ids, in task_create() order
+#   --period  prints the min, mean and max time between dispatches of a task, e.g. the eFix task
+#
+import json
+import sys
+
+TRACE_FRAME_SOT = 0xa5
+RECORD_SIZE = 4
+US_PER_COUNT = 3.2
+
+# Record types, see os_trace.h
+TRACE_TASK_DISPATCH = 1
+TRACE_TASK_YIELD = 2
+TRACE_EVENT_SIGNAL = 3
+TRACE_SEM_TAKE = 4
+TRACE_SEM_GIVE = 5
+TRACE_MSG_POST = 6
+
+INSTANT_NAMES = {
+	TRACE_EVENT_SIGNAL: 'event {0} signaled',
+	TRACE_SEM_TAKE: 'semaphore {0} taken',
+	TRACE_SEM_GIVE: 'semaphore {0} given',
+	TRACE_MSG_POST: 'message posted to queue {0}',
+}
+
+KERNEL_TRACK = 255
+
+
+#
+# Splits a capture into frames and returns a list of (lost count, [(type, id, time), ...]).
+# Bytes that do not start a frame with a valid checksum are skipped.
+#
+def ParseFrames(data):
+	frames = []
+	bad_frames = 0
+	i = 0
+
+	while i + 4 <= len(data):
+		if data[i] != TRACE_FRAME_SOT:
+			i += 1
+			continue
+
+		num_records = data[i + 1]
+		size = 3 + num_records * RECORD_SIZE + 1
+
+		if i + size > len(data) or (sum(data[i:i + size]) & 0xff) != 0:
+			bad_frames += 1
+			i += 1
+			continue
+
+		records = []
+		for r in range(num_records):
+			ofs = i + 3 + r * RECORD_SIZE
+			records.append((data[ofs], data[ofs + 1], data[ofs + 2] | (data[ofs + 3] << 8)))
+
+		frames.append((data[i + 2], records))
+		i += size
+
+	return frames, bad_frames
+# End of ParseFrames
+
+
+#
+# Builds the Chrome trace events and the dispatch times of each task, in us.
+#
+def BuildEvents(frames, names):
+	events = []
+	dispatches = {}
+	time = 0
+	last_count = None
+
+	for lost, records in frames:
+		if lost:
+			events.append({'name': '{0} records lost'.format(lost), 'ph': 'i', 's': 'g',
+				'ts': time * US_PER_COUNT, 'pid': 1, 'tid': KERNEL_TRACK})
+
+		for record_type, record_id, count in records:
+			if last_count is not None:
+				time += (count - last_count) & 0xffff
+			last_count = count
+			ts = time * US_PER_COUNT
+
+			if record_type == TRACE_TASK_DISPATCH:
+				events.append({'name': names.get(record_id, 'task {0}'.format(record_id)), 'ph': 'B',
+					'ts': ts, 'pid': 1, 'tid': record_id})
+				dispatches.setdefault(record_id, []).append(ts)
+			elif record_type == TRACE_TASK_YIELD:
+				events.append({'ph': 'E', 'ts': ts, 'pid': 1, 'tid': record_id})
+			elif record_type in INSTANT_NAMES:
+				events.append({'name': INSTANT_NAMES[record_type].format(record_id), 'ph': 'i', 's': 't',
+					'ts': ts, 'pid': 1, 'tid': KERNEL_TRACK})
+
+	events.append({'name': 'thread_name', 'ph': 'M', 'pid': 1, 'tid': KERNEL_TRACK, 'args': {'name': 'kernel'}})
+	for tid in sorted(dispatches):
+		events.append({'name': 'thread_name', 'ph': 'M', 'pid': 1, 'tid': tid,
+			'args': {'name': names.get(tid, 'task {0}'.format(tid))}})
+
+	return events, dispatches
+# End of BuildEvents
+
+
+#
+# Parses the --names argument, "0=Main,1=eFix" -> {0: 'Main', 1: 'eFix'}.
+#
+def ParseNames(text):
+	names = {}
+	for item in text.split(','):
+		tid, name = item.split('=', 1)
+		names[int(tid)] = name
+	return names
+# End of ParseNames
+
+
+if __name__ == "__main__":
+	args = sys.argv[1:]
+	names = {}
+	period_tid = None
+
+	if '--names' in args:
+		i = args.index('--names')
+		names = ParseNames(args[i + 1])
+		del args[i:i + 2]
+
+	if '--period' in args:
+		i = args.index('--period')
+		period_tid = int(args[i + 1])
+		del args[i:i + 2]
+
+	if len(args) != 2:
+		print('Usage: python trace_export.py capture.bin trace.json [--names 0=Main,...] [--period TID]')
+		sys.exit(1)
+
+	with open(args[0], 'rb') as f:
+		data = bytearray(f.read())
+
+	frames, bad_frames = ParseFrames(data)
+	events, dispatches = BuildEvents(frames, names)
+
+	with open(args[1], 'w') as f:
+		json.dump({'traceEvents': events, 'displayTimeUnit': 'ms'}, f)
+
+	print('{0} frames, {1} records, {2} bad frames skipped'.format(
+		len(frames), sum(len(r) for _, r in frames), bad_frames))
+
+	if period_tid is not None:
+		times = dispatches.get(period_tid, [])
+		periods = [b - a for a, b in zip(times, times[1:])]
+		if periods:
+			print('Task {0}: {1} periods, min {2:.2f} ms, mean {3:.2f} ms, max {4:.2f} ms'.format(
+				period_tid, len(periods), min(periods) / 1000.0, sum(periods) / len(periods) / 1000.0,
+				max(periods) / 1000.0))
+		else:
+			print('Task {0}: fewer than 2 dispatches'.format(period_tid))